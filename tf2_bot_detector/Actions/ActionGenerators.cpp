@@ -1,41 +1,200 @@
 #include "ActionGenerators.h"
 #include "Actions.h"
 #include "IActionManager.h"
+#include "RCONActionManager.h"
+#include "ConsoleLog/ConsoleLines/LobbyHeaderLine.h"
+#include "ConsoleLog/IConsoleLine.h"
+#include "GameData/IPlayer.h"
 #include "Log.h"
+#include "WorldState.h"
+
+#include <algorithm>
+#include <functional>
 
 using namespace tf2_bot_detector;
 using namespace std::chrono_literals;
 
-duration_t StatusUpdateActionGenerator::GetInterval() const
+namespace
 {
-	return 3s;
+	// How long after a lobby change/server join/pending lobby member we keep polling quickly
+	static constexpr duration_t CHURN_DURATION = 20s;
+
+	static constexpr duration_t STATUS_INTERVAL_CHURN = 1s;
+	static constexpr duration_t STATUS_INTERVAL_BASE = 3s;
+
+	// Players whose status is older than this are treated as gone by GetBotLeader() and
+	// left out of the server ping, so the longest gap between status polls has to stay
+	// comfortably under it.
+	static constexpr duration_t STATUS_FRESHNESS_WINDOW = 20s;
+	static constexpr duration_t STATUS_INTERVAL_MAX = 12s;
+	static_assert(STATUS_INTERVAL_MAX < STATUS_FRESHNESS_WINDOW);
+
+	// Ping has nothing to back off on, it goes out with a status poll at about this rate
+	static constexpr duration_t PING_INTERVAL = 6s;
+
+	static constexpr duration_t LOBBY_INTERVAL_BASE = 1s;
+	static constexpr duration_t LOBBY_INTERVAL_MAX = 8s;
+
+	// Give the game at least this many round trips worth of time between polls
+	static constexpr int LATENCY_FLOOR_MULTIPLIER = 2;
+
+	size_t CombineHash(size_t seed, size_t value)
+	{
+		return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+	}
 }
 
-bool StatusUpdateActionGenerator::ExecuteImpl(IActionManager& manager)
+PollingRateController::PollingRateController(IWorldState& world, const RCONActionManager& actionManager) :
+	AutoConsoleLineListener(world),
+	m_World(world),
+	m_ActionManager(actionManager)
 {
-	// 3 second interval, we want:
-	//   1. status
-	//   2. ping
-	//   3. status short
-	//   4. ping
-	// repeat
+}
 
-	if (m_NextPing)
+bool PollingRateController::Backoff::Update(size_t signature)
+{
+	if (signature == m_LastSignature)
 	{
-		if (!manager.QueueAction<GenericCommandAction>("ping"))
-			return false;
+		m_UnchangedPolls++;
+		return false;
 	}
-	else
+
+	m_LastSignature = signature;
+	m_UnchangedPolls = 0;
+	return true;
+}
+
+duration_t PollingRateController::Backoff::GetInterval(duration_t base, duration_t max) const
+{
+	// The first unchanged poll doesn't count, it's usually just the one right after a change
+	duration_t interval = base;
+	for (unsigned i = 1; i < m_UnchangedPolls && interval < max; i++)
+		interval *= 2;
+
+	return std::min(interval, max);
+}
+
+void PollingRateController::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
+{
+	switch (line.GetType())
 	{
-		//if (!manager.QueueAction<GenericCommandAction>("status", m_NextShort ? "short" : ""))
-		//	return false;
+	case ConsoleLineType::LobbyChanged:
+	case ConsoleLineType::ServerJoin:
+		OnChurn();
+		break;
 
-		//m_NextShort = !m_NextShort;
-		if (!manager.QueueAction<GenericCommandAction>("status"))
-			return false;
+	case ConsoleLineType::LobbyHeader:
+		if (static_cast<const LobbyHeaderLine&>(line).GetPendingCount() > 0)
+			OnChurn();
+
+		break;
+
+	default:
+		break;
 	}
+}
 
-	m_NextPing = !m_NextPing;
+bool PollingRateController::IsChurning() const
+{
+	return (tfbd_clock_t::now() - m_LastChurnTime) < CHURN_DURATION;
+}
+
+void PollingRateController::OnChurn()
+{
+	m_LastChurnTime = tfbd_clock_t::now();
+	m_StatusBackoff.m_UnchangedPolls = 0;
+	m_LobbyBackoff.m_UnchangedPolls = 0;
+}
+
+duration_t PollingRateController::GetLatencyFloor(const std::string_view& cmd) const
+{
+	const auto& stats = m_ActionManager.GetCommandLatencyStats();
+	if (auto found = stats.find(cmd); found != stats.end())
+		return std::chrono::duration_cast<duration_t>(found->second.m_Recent * LATENCY_FLOOR_MULTIPLIER);
+
+	return {};
+}
+
+duration_t PollingRateController::GetStatusInterval() const
+{
+	const auto interval = IsChurning() ? STATUS_INTERVAL_CHURN :
+		m_StatusBackoff.GetInterval(STATUS_INTERVAL_BASE, STATUS_INTERVAL_MAX);
+
+	// Even if RCON is that slow, going past the max would let players' status go stale
+	return std::min(std::max(interval, GetLatencyFloor("status")), STATUS_INTERVAL_MAX);
+}
+
+duration_t PollingRateController::GetLobbyDebugInterval() const
+{
+	const auto interval = IsChurning() ? LOBBY_INTERVAL_BASE :
+		m_LobbyBackoff.GetInterval(LOBBY_INTERVAL_BASE, LOBBY_INTERVAL_MAX);
+
+	return std::max(interval, GetLatencyFloor("tf_lobby_debug"));
+}
+
+void PollingRateController::OnStatusPoll()
+{
+	// Order independent, so it doesn't matter how the players are stored
+	size_t signature = 0;
+	for (const IPlayer& player : m_World.GetPlayers())
+	{
+		size_t playerHash = std::hash<SteamID>{}(player.GetSteamID());
+		playerHash = CombineHash(playerHash, std::hash<std::string>{}(player.GetNameUnsafe()));
+		playerHash = CombineHash(playerHash, size_t(player.GetConnectionState()));
+		signature += playerHash;
+	}
+
+	m_StatusBackoff.Update(signature);
+}
+
+void PollingRateController::OnLobbyDebugPoll()
+{
+	size_t signature = 0;
+	bool anyPending = false;
+	for (const IPlayer& player : m_World.GetLobbyMembers())
+	{
+		size_t memberHash = std::hash<SteamID>{}(player.GetSteamID());
+		if (auto member = player.GetLobbyMember())
+		{
+			memberHash = CombineHash(memberHash, size_t(member->m_Team));
+			memberHash = CombineHash(memberHash, size_t(member->m_Pending));
+			anyPending |= member->m_Pending;
+		}
+
+		signature += memberHash;
+	}
+
+	if (anyPending)
+		OnChurn();
+
+	// Someone joined, left or switched teams since the last poll. Status will show them
+	// soon, so don't wait for it to notice on its own.
+	if (m_LobbyBackoff.Update(signature))
+		m_StatusBackoff.m_UnchangedPolls = 0;
+}
+
+duration_t StatusUpdateActionGenerator::GetInterval() const
+{
+	return m_Controller.GetStatusInterval();
+}
+
+bool StatusUpdateActionGenerator::ExecuteImpl(IActionManager& manager)
+{
+	// Status every interval (see PollingRateController), and ping along with it every
+	// PING_INTERVAL or so. The backoff only ever slows down status, not ping.
+
+	//if (!manager.QueueAction<GenericCommandAction>("status", m_NextShort ? "short" : ""))
+	//	return false;
+
+	//m_NextShort = !m_NextShort;
+	if (!manager.QueueAction<GenericCommandAction>("status"))
+		return false;
+
+	m_Controller.OnStatusPoll();
+
+	const auto now = tfbd_clock_t::now();
+	if ((now - m_LastPingTime) >= PING_INTERVAL && manager.QueueAction<GenericCommandAction>("ping"))
+		m_LastPingTime = now;
 
 	return true;
 }
@@ -87,8 +246,15 @@ bool IPeriodicActionGenerator::Execute(IActionManager& manager)
 	return true;
 }
 
+duration_t LobbyDebugActionGenerator::GetInterval() const
+{
+	return m_Controller.GetLobbyDebugInterval();
+}
+
 bool LobbyDebugActionGenerator::ExecuteImpl(IActionManager& manager)
 {
+	m_Controller.OnLobbyDebugPoll();
+
 	if (!manager.QueueAction<GenericCommandAction>("tf_lobby_debug"))
 		return false;
 	if (!manager.QueueAction<GenericCommandAction>("tf_party_debug"))
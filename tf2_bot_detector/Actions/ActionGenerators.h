@@ -1,11 +1,16 @@
 #pragma once
 
+#include "ConsoleLog/ConsoleLineListener.h"
 #include "Clock.h"
 
+#include <string_view>
+
 namespace tf2_bot_detector
 {
 	class IAction;
 	class IActionManager;
+	class IWorldState;
+	class RCONActionManager;
 
 	class IActionGenerator
 	{
@@ -32,17 +37,59 @@ namespace tf2_bot_detector
 		time_point_t m_LastRunTime{};
 	};
 
+	// Decides how often StatusUpdateActionGenerator and LobbyDebugActionGenerator poll.
+	// They speed up while players are joining or leaving, back off exponentially while
+	// nothing changes between polls, and never poll faster than RCON answers.
+	class PollingRateController final : AutoConsoleLineListener
+	{
+	public:
+		PollingRateController(IWorldState& world, const RCONActionManager& actionManager);
+
+		duration_t GetStatusInterval() const;
+		duration_t GetLobbyDebugInterval() const;
+
+		// Called right before polling, to compare what we know now to what the previous poll found
+		void OnStatusPoll();
+		void OnLobbyDebugPoll();
+
+	private:
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
+
+		bool IsChurning() const;
+		void OnChurn();
+		duration_t GetLatencyFloor(const std::string_view& cmd) const;
+
+		struct Backoff
+		{
+			// Returns true if the signature changed
+			bool Update(size_t signature);
+			duration_t GetInterval(duration_t base, duration_t max) const;
+
+			size_t m_LastSignature = 0;
+			unsigned m_UnchangedPolls = 0;
+		};
+
+		const IWorldState& m_World;
+		const RCONActionManager& m_ActionManager;
+		time_point_t m_LastChurnTime{};
+		Backoff m_StatusBackoff;
+		Backoff m_LobbyBackoff;
+	};
+
 	class StatusUpdateActionGenerator final : public IPeriodicActionGenerator
 	{
 	public:
+		StatusUpdateActionGenerator(PollingRateController& controller) : m_Controller(controller) {}
+
 		duration_t GetInterval() const override;
 
 	protected:
 		bool ExecuteImpl(IActionManager& manager) override;
 
 	private:
+		PollingRateController& m_Controller;
 		bool m_NextShort = false;
-		bool m_NextPing = false;
+		time_point_t m_LastPingTime{};
 	};
 
 	class ConfigActionGenerator final : public IPeriodicActionGenerator
@@ -57,9 +104,14 @@ namespace tf2_bot_detector
 	class LobbyDebugActionGenerator final : public IPeriodicActionGenerator
 	{
 	public:
-		duration_t GetInterval() const override { return std::chrono::seconds(1); }
+		LobbyDebugActionGenerator(PollingRateController& controller) : m_Controller(controller) {}
+
+		duration_t GetInterval() const override;
 
 	protected:
 		bool ExecuteImpl(IActionManager& manager) override;
+
+	private:
+		PollingRateController& m_Controller;
 	};
 }
@@ -10,6 +10,7 @@
 #include <mh/text/string_insertion.hpp>
 #include <srcon/async_client.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <iomanip>
 #include <queue>
@@ -38,6 +39,37 @@ struct SRCONInit
 
 } s_SRCONInit;
 
+namespace
+{
+	// Commands that run entirely on the client
+	static const std::unordered_set<std::string_view> s_KnownClientCommands =
+	{
+		"tf_lobby_debug",
+		"tf_party_debug",
+		"net_status",
+		"con_logfile",
+		"con_timestamp",
+		"tf_mm_debug_level",
+		"net_showmsg",
+	};
+
+	// Commands that don't change anything on the server and whose output the console line
+	// parsers recognize line by line. Several of these can share one RCON packet, since we
+	// never need to know which part of the response came from which command.
+	bool IsPackableCommand(const std::string_view& cmd)
+	{
+		return cmd == "status"sv || cmd == "ping"sv || s_KnownClientCommands.contains(cmd);
+	}
+
+	// Stay under the engine's 512 character command buffer limit
+	static constexpr size_t MAX_PACKED_COMMAND_LENGTH = 500;
+
+	std::string_view GetCommandName(const std::string_view& cmd)
+	{
+		return cmd.substr(0, cmd.find(' '));
+	}
+}
+
 std::unique_ptr<RCONActionManager> RCONActionManager::Create(const Settings& settings, IWorldState& world)
 {
 	return std::make_unique<RCONActionManager>(settings, world);
@@ -88,6 +120,20 @@ void RCONActionManager::OnLocalPlayerInitialized(IWorldState& world, bool initia
 		m_IsDiscardingServerCommands, m_Settings.m_ConfigCompatibilityMode);
 }
 
+void RCONActionManager::CommandLatencyStats::Record(latency_clock_t::duration latency)
+{
+	m_Count++;
+	m_Recent = (m_Count == 1) ? latency : (m_Recent + (latency - m_Recent) / 8);
+	m_Total += latency;
+	m_Max = std::max(m_Max, latency);
+
+	size_t bucket = 0;
+	while (bucket < (BUCKET_COUNT - 1) && latency > GetBucketUpperBound(bucket))
+		bucket++;
+
+	m_Buckets[bucket]++;
+}
+
 void RCONActionManager::ProcessRunningCommands()
 {
 	constexpr const char* funcName = __func__;
@@ -96,11 +142,25 @@ void RCONActionManager::ProcessRunningCommands()
 		return DebugLogWarning(""s << funcName << "(): " << msg);
 	};
 
-	while (!m_RunningCommands.empty())
+	for (auto it = m_RunningCommands.begin(); it != m_RunningCommands.end(); )
 	{
-		auto& cmd = m_RunningCommands.front();
+		auto& cmd = *it;
 		if (cmd.m_Future.wait_for(0s) == std::future_status::timeout)
-			break;
+		{
+			++it;
+			continue;
+		}
+
+		const auto elapsed = latency_clock_t::now() - cmd.m_StartTime;
+		for (const auto& single : cmd.m_Commands)
+		{
+			const auto name = GetCommandName(single);
+			auto stats = m_LatencyStats.find(name);
+			if (stats == m_LatencyStats.end())
+				stats = m_LatencyStats.emplace(std::string(name), CommandLatencyStats{}).first;
+
+			stats->second.Record(elapsed);
+		}
 
 		try
 		{
@@ -108,8 +168,8 @@ void RCONActionManager::ProcessRunningCommands()
 
 			if (m_Settings.m_Unsaved.m_DebugShowCommands)
 			{
-				const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(tf2_bot_detector::clock_t::now() - cmd.m_StartTime);
-				std::string msg = "Game command processed in "s << elapsed.count() << "ms : " << std::quoted(cmd.m_Command);
+				const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+				std::string msg = "Game command processed in "s << elapsedMs.count() << "ms : " << std::quoted(cmd.m_Command);
 
 				if (!resultStr.empty())
 					msg << ", response " << resultStr.size() << " bytes";
@@ -133,8 +193,38 @@ void RCONActionManager::ProcessRunningCommands()
 			PrintErrorMsg(""s << e.what() << ": " << std::quoted(cmd.m_Command));
 		}
 
-		m_RunningCommands.pop();
+		it = m_RunningCommands.erase(it);
+	}
+}
+
+bool RCONActionManager::IsCommandRunning(const std::string_view& cmd) const
+{
+	for (const auto& running : m_RunningCommands)
+	{
+		if (std::find(running.m_Commands.begin(), running.m_Commands.end(), cmd) != running.m_Commands.end())
+			return true;
 	}
+
+	return false;
+}
+
+void RCONActionManager::SendCommands(std::vector<std::string> commands)
+{
+	if (commands.empty())
+		return;
+
+	std::string packet = commands.front();
+	for (size_t i = 1; i < commands.size(); i++)
+		packet << ';' << commands[i];
+
+	auto future = m_Settings.m_Unsaved.m_RCONClient->send_command_async(packet, false);
+	m_RunningCommands.push_back(
+		{
+			.m_StartTime = latency_clock_t::now(),
+			.m_Command = std::move(packet),
+			.m_Commands = std::move(commands),
+			.m_Future = std::move(future),
+		});
 }
 
 /// <summary>
@@ -147,17 +237,6 @@ bool RCONActionManager::ShouldDiscardCommand(const std::string_view& cmd) const
 	if (!m_IsDiscardingServerCommands || !m_Settings.m_ConfigCompatibilityMode)
 		return false;
 
-	static const std::unordered_set<std::string_view> s_KnownClientCommands =
-	{
-		"tf_lobby_debug",
-		"tf_party_debug",
-		"net_status",
-		"con_logfile",
-		"con_timestamp",
-		"tf_mm_debug_level",
-		"net_showmsg",
-	};
-
 	if (s_KnownClientCommands.contains(cmd))
 		return false;
 
@@ -189,18 +268,55 @@ void RCONActionManager::ProcessQueuedCommands()
 				if (m_Manager->ShouldDiscardCommand(cmd))
 					return;
 
+				const bool packable = IsPackableCommand(cmd);
+
 				if (!args.empty())
 					cmd << ' ' << args;
 
-				m_Manager->m_RunningCommands.push(
+				if (!packable)
+				{
+					// Repeats of these may be intentional (say, callvote...), so send every
+					// one, and keep them in order with whatever was queued before them.
+					Flush();
+					m_Manager->SendCommands({ std::move(cmd) });
+					return;
+				}
+
+				// Merge with an identical command that hasn't come back yet
+				if (m_Manager->IsCommandRunning(cmd) ||
+					std::find(m_Packable.begin(), m_Packable.end(), cmd) != m_Packable.end())
+				{
+					return;
+				}
+
+				m_Packable.push_back(std::move(cmd));
+			}
+
+			// Sends everything in m_Packable in as few packets as possible
+			void Flush()
+			{
+				std::vector<std::string> packet;
+				size_t packetLength = 0;
+
+				for (auto& cmd : m_Packable)
+				{
+					if (!packet.empty() && (packetLength + 1 + cmd.size()) > MAX_PACKED_COMMAND_LENGTH)
 					{
-						.m_StartTime = tfbd_clock_t::now(),
-						.m_Command = cmd,
-						.m_Future = m_Manager->m_Settings.m_Unsaved.m_RCONClient->send_command_async(cmd, false),
-					});
+						m_Manager->SendCommands(std::move(packet));
+						packet.clear();
+						packetLength = 0;
+					}
+
+					packetLength += (packet.empty() ? 0 : 1) + cmd.size();
+					packet.push_back(std::move(cmd));
+				}
+
+				m_Manager->SendCommands(std::move(packet));
+				m_Packable.clear();
 			}
 
 			RCONActionManager* m_Manager = nullptr;
+			std::vector<std::string> m_Packable;
 
 		} writer;
 
@@ -233,6 +349,8 @@ void RCONActionManager::ProcessQueuedCommands()
 			else
 				++it;
 		}
+
+		writer.Flush();
 	}
 
 	m_LastUpdateTime = curTime;
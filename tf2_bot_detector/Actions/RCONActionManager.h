@@ -11,9 +11,11 @@
 #include <mh/text/string_insertion.hpp>
 #include <srcon/async_client.h>
 
+#include <array>
+#include <chrono>
 #include <filesystem>
 #include <iomanip>
-#include <queue>
+#include <map>
 #include <regex>
 #include <unordered_set>
 
@@ -48,18 +50,53 @@ namespace tf2_bot_detector
 			return AddPeriodicActionGenerator(std::make_unique<TAction>(std::forward<TArgs>(args)...));
 		}
 
+		using latency_clock_t = std::chrono::steady_clock;
+
+		// Round trip times of one command name (the first word of the command), bucketed
+		// by powers of two milliseconds. Measured from sending the command until Update()
+		// notices the response, so the resolution is limited by how often that runs.
+		struct CommandLatencyStats
+		{
+			static constexpr size_t BUCKET_COUNT = 13;
+
+			// Bucket i holds latencies up to 2^i ms. The last bucket also holds everything above that.
+			static constexpr std::chrono::milliseconds GetBucketUpperBound(size_t bucket)
+			{
+				return std::chrono::milliseconds(1ll << bucket);
+			}
+
+			void Record(latency_clock_t::duration latency);
+
+			uint64_t m_Count = 0;
+			latency_clock_t::duration m_Recent{};  // Moving average of the last several samples
+			latency_clock_t::duration m_Total{};
+			latency_clock_t::duration m_Max{};
+			std::array<uint64_t, BUCKET_COUNT> m_Buckets{};
+		};
+
+		const std::map<std::string, CommandLatencyStats, std::less<>>& GetCommandLatencyStats() const { return m_LatencyStats; }
+		void ResetCommandLatencyStats() { m_LatencyStats.clear(); }
+
 	private:
 		void OnLocalPlayerInitialized(IWorldState& world, bool initialized) override;
 
 		struct RunningCommand
 		{
-			time_point_t m_StartTime{};
-			std::string m_Command;
+			latency_clock_t::time_point m_StartTime{};
+			std::string m_Command;                // What was actually sent, possibly several ;-joined commands
+			std::vector<std::string> m_Commands;  // The individual commands in m_Command
 			std::shared_future<std::string> m_Future;
 		};
-		std::queue<RunningCommand> m_RunningCommands;
+
+		// Not a queue: responses don't necessarily come back in the order we sent them,
+		// and one slow command shouldn't hold up everything behind it.
+		std::vector<RunningCommand> m_RunningCommands;
 		void ProcessRunningCommands();
 		void ProcessQueuedCommands();
+		bool IsCommandRunning(const std::string_view& cmd) const;
+		void SendCommands(std::vector<std::string> commands);
+
+		std::map<std::string, CommandLatencyStats, std::less<>> m_LatencyStats;
 
 		struct Writer;
 
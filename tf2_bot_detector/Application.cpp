@@ -10,6 +10,7 @@
 #include "Actions/ActionGenerators.h"
 #include "BaseTextures.h"
 #include "Filesystem.h"
+#include "FrameScheduler.h"
 #include "GenericErrors.h"
 #include "Log.h"
 #include "GameData/IPlayer.h"
@@ -17,6 +18,7 @@
 #include "TextureManager.h"
 #include "UpdateManager.h"
 #include "Util/PathUtils.h"
+#include "Util/PerfCounters.h"
 #include "Version.h"
 #include "GlobalDispatcher.h"
 #include "Networking/HTTPClient.h"
@@ -78,15 +80,17 @@ TF2BDApplication::TF2BDApplication() :
 
 	m_OpenTime = clock_t::now();
 
-	GetActionManager().AddPeriodicActionGenerator<StatusUpdateActionGenerator>();
+	m_PollingRateController = std::make_unique<PollingRateController>(GetWorld(), GetActionManager());
+	GetActionManager().AddPeriodicActionGenerator<StatusUpdateActionGenerator>(*m_PollingRateController);
 	GetActionManager().AddPeriodicActionGenerator<ConfigActionGenerator>();
-	GetActionManager().AddPeriodicActionGenerator<LobbyDebugActionGenerator>();
-
-	// always run at first tick.
-	QueueUpdate();
+	GetActionManager().AddPeriodicActionGenerator<LobbyDebugActionGenerator>(*m_PollingRateController);
 }
 
-TF2BDApplication::~TF2BDApplication() = default;
+TF2BDApplication::~TF2BDApplication()
+{
+	// Don't leave the last settings/playerlist changes to static destruction
+	ConfigFileBase::FlushDeferredSaves();
+}
 
 TF2BDApplication& TF2BDApplication::GetApplication()
 {
@@ -148,7 +152,10 @@ void TF2BDApplication::OnConsoleLogChunkParsed(IWorldState& world, bool consoleL
 	assert(&world == &GetWorld());
 
 	if (consoleLinesUpdated)
+	{
 		UpdateServerPing(GetCurrentTimestampCompensated());
+		GetFrameScheduler().RequestFrame(WakeReason::ConsoleLog);
+	}
 }
 
 bool TF2BDApplication::IsTimeEven() const
@@ -187,6 +194,9 @@ void TF2BDApplication::UpdateServerPing(time_point_t timestamp)
 		samples++;
 	}
 
+	if (samples == 0)
+		return;
+
 	m_ServerPingSamples.push_back({ timestamp, uint16_t(totalPing / samples) });
 	m_LastServerPingSample = timestamp;
 
@@ -199,6 +209,8 @@ void tf2_bot_detector::TF2BDApplication::Update()
 	if (m_Paused)
 		return;
 
+	TFBD_PERF_SCOPE("Update");
+
 	GetDispatcher().run_for(10ms);
 
 	GetWorld().Update();
@@ -220,13 +232,20 @@ void tf2_bot_detector::TF2BDApplication::Update()
 		GetModLogic().Update();
 
 		m_MainState->OnUpdateDiscord();
+
+		if (const auto version = GetModLogic().GetPlayerAttributesVersion(); version != m_LastPlayerAttributesVersion)
+		{
+			m_LastPlayerAttributesVersion = version;
+			GetFrameScheduler().RequestFrame(WakeReason::World);
+		}
 	}
 
 	GetActionManager().Update();
 
-	// set our "should update even tabbed out" variable to false
-	if (b_ShouldUpdate) {
-		b_ShouldUpdate = false;
+	if (const auto version = GetWorld().GetPlayerDataVersion(); version != m_LastPlayerDataVersion)
+	{
+		m_LastPlayerDataVersion = version;
+		GetFrameScheduler().RequestFrame(WakeReason::World);
 	}
 }
 
@@ -352,13 +371,13 @@ bool TF2BDApplication::IsSleepingEnabled() const
 }
 
 /// <summary>
-/// force our program to update, even if sleeping is enabled and our application is sleeping,
+/// force our program to update and redraw, even if sleeping is enabled and our application is sleeping,
 /// aka wake it up
 /// </summary>
 /// <returns></returns>
 void TF2BDApplication::QueueUpdate()
 {
-	b_ShouldUpdate = true;
+	GetFrameScheduler().RequestFrame(WakeReason::Requested);
 }
 
 /// <summary>
@@ -367,5 +386,5 @@ void TF2BDApplication::QueueUpdate()
 /// <returns></returns>
 bool TF2BDApplication::ShouldUpdate()
 {
-	return !this->IsSleepingEnabled() || b_ShouldUpdate;
+	return GetFrameScheduler().IsUpdateDue();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Actions/ActionGenerators.h"
 #include "Actions/Actions.h"
 #include "Actions/RCONActionManager.h"
 #include "Clock.h"
@@ -51,9 +52,7 @@ namespace tf2_bot_detector
 		std::unique_ptr<DB::ITempDB> m_TempDB;
 
 		// moved from "MainWindow"
-		const void* m_LastLogMessage = nullptr;
-
-		bool IsSleepingEnabled() const;
+		std::optional<uint64_t> m_LastLogMessage;
 
 		bool IsTimeEven() const;
 		float TimeSine(float interval = 1.0f, float min = 0, float max = 1) const;
@@ -121,12 +120,11 @@ namespace tf2_bot_detector
 		std::unique_ptr<IUpdateManager> m_UpdateManager;
 		std::shared_ptr<IWorldState> m_WorldState;
 		std::unique_ptr<RCONActionManager> m_ActionManager;
+		std::unique_ptr<PollingRateController> m_PollingRateController;
 
-		/// <summary>
-		/// for "sleep when unfocused" feature.
-		/// note: it still will update, when a new log as been processed.
-		/// </summary>
-		bool b_ShouldUpdate = false;
+		// Last versions we saw in Update(), a change means the ui needs a redraw
+		uint64_t m_LastPlayerDataVersion = 0;
+		uint64_t m_LastPlayerAttributesVersion = 0;
 
 		struct PostSetupFlowState
 		{
@@ -153,6 +151,12 @@ namespace tf2_bot_detector
 		bool ShouldUpdate();
 		void Update();
 
+		/// <summary>
+		/// for "sleep when unfocused" feature: skip idle redraws while unfocused.
+		/// note: it still will redraw when something changes.
+		/// </summary>
+		bool IsSleepingEnabled() const;
+
 		std::optional<PostSetupFlowState>& GetMainState() { return m_MainState; }
 
 		/// <summary>
@@ -57,7 +57,10 @@ std::shared_ptr<ITexture> BaseTextures::TryLoadTexture(std::filesystem::path fil
 
 	try
 	{
-		return m_TextureManager.CreateTexture(Bitmap(file));
+		// They're all tiny, and usually drawn right next to each other
+		TextureSettings settings{};
+		settings.m_Atlas = true;
+		return m_TextureManager.CreateTexture(Bitmap(file), settings);
 	}
 	catch (const std::exception& e)
 	{
@@ -0,0 +1,344 @@
+#include "BenchData.h"
+#include "Config/ChatWrappers.h"
+#include "Config/PlayerListJSON.h"
+#include "Config/Settings.h"
+#include "WorldState.h"
+
+#include <mh/text/format.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+using namespace tf2_bot_detector::Bench;
+
+namespace
+{
+	static constexpr std::string_view NAME_PARTS[] =
+	{
+		"xX"sv, "Xx"sv, "pyro"sv, "scout"sv, "heavy"sv, "medic"sv, "spy"sv, "sniper"sv, "demo"sv, "engi"sv,
+		"soldier"sv, "bot"sv, "gamer"sv, "pro"sv, "noob"sv, "the"sv, "dr."sv, "mr."sv, "[TF2]"sv, "|"sv,
+		"killer"sv, "hat"sv, "crit"sv, "backstab"sv, "420"sv, "1337"sv, "\xe2\x98\x85"sv, "\xe3\x83\x84"sv,
+	};
+
+	static constexpr std::string_view CHAT_WORDS[] =
+	{
+		"gg"sv, "lol"sv, "nice"sv, "shot"sv, "medic"sv, "pls"sv, "push"sv, "cart"sv, "why"sv, "is"sv,
+		"the"sv, "sentry"sv, "up"sv, "spy"sv, "behind"sv, "you"sv, "uber"sv, "ready"sv, "go"sv, "kick"sv,
+		"bot"sv, "cheater"sv, "on"sv, "red"sv, "blu"sv, "team"sv, "wtf"sv, "ez"sv, "report"sv, "him"sv,
+	};
+
+	static constexpr std::string_view RULE_PATTERN_CHARS = "abcdefghijklmnopqrstuvwxyz0123456789"sv;
+
+	template<typename T, size_t N>
+	const T& Pick(std::mt19937& random, const T(&array)[N])
+	{
+		return array[std::uniform_int_distribution<size_t>(0, N - 1)(random)];
+	}
+
+	size_t Roll(std::mt19937& random, size_t min, size_t max)
+	{
+		return std::uniform_int_distribution<size_t>(min, max)(random);
+	}
+
+	std::string GenerateRulePattern(std::mt19937& random)
+	{
+		std::string retVal(Roll(random, 4, 12), '\0');
+		for (auto& c : retVal)
+			c = RULE_PATTERN_CHARS[Roll(random, 0, RULE_PATTERN_CHARS.size() - 1)];
+
+		return retVal;
+	}
+
+	TextMatch GenerateTextMatch(std::mt19937& random)
+	{
+		TextMatch retVal;
+
+		// Roughly the distribution of modes in the official rules
+		const auto roll = Roll(random, 0, 99);
+		if (roll < 40)
+			retVal.m_Mode = TextMatchMode::Contains;
+		else if (roll < 60)
+			retVal.m_Mode = TextMatchMode::Equal;
+		else if (roll < 70)
+			retVal.m_Mode = TextMatchMode::StartsWith;
+		else if (roll < 80)
+			retVal.m_Mode = TextMatchMode::EndsWith;
+		else if (roll < 95)
+			retVal.m_Mode = TextMatchMode::Word;
+		else
+			retVal.m_Mode = TextMatchMode::Regex;
+
+		const auto patternCount = Roll(random, 1, 5);
+		for (size_t i = 0; i < patternCount; i++)
+		{
+			if (retVal.m_Mode == TextMatchMode::Regex)
+				retVal.m_Patterns.push_back(mh::format("^{}.*[0-9]+$", GenerateRulePattern(random)));
+			else
+				retVal.m_Patterns.push_back(GenerateRulePattern(random));
+		}
+
+		retVal.m_CaseSensitive = Roll(random, 0, 3) == 0;
+		return retVal;
+	}
+
+	std::string FormatChatLine(const ChatWrappers& wrappers, ChatCategory category,
+		const std::string_view& name, const std::string_view& message)
+	{
+		const auto& type = wrappers.m_Types[size_t(category)];
+
+		return mh::format("{}{}{}{} :  {}{}{}{}",
+			type.m_Full.m_Start.m_Narrow, type.m_Name.m_Start.m_Narrow, name, type.m_Name.m_End.m_Narrow,
+			type.m_Message.m_Start.m_Narrow, message, type.m_Message.m_End.m_Narrow, type.m_Full.m_End.m_Narrow);
+	}
+}
+
+Settings& Bench::GetSettings()
+{
+	static Settings& s_Settings = []() -> Settings&
+	{
+		static Settings settings;
+		settings.m_AllowInternetUsage = false;
+
+		ChatFmtStrLengths lengths;
+		for (auto& type : lengths.m_Types)
+			type = ChatFmtStrLengths::Type(16, 4, 0);
+
+		settings.m_Unsaved.m_ChatMsgWrappers = ChatWrappers(lengths);
+		return settings;
+	}();
+
+	return s_Settings;
+}
+
+IWorldState& Bench::GetWorldState()
+{
+	static const std::shared_ptr<IWorldState> s_WorldState = IWorldState::Create(GetSettings());
+	return *s_WorldState;
+}
+
+const ChatWrappers& Bench::GetChatWrappers()
+{
+	return *GetSettings().m_Unsaved.m_ChatMsgWrappers;
+}
+
+std::vector<SteamID> Bench::GenerateSteamIDs(size_t count, uint32_t seed)
+{
+	std::mt19937 random(seed);
+
+	// Unique by construction, then shuffled so lookups don't walk the map in order
+	std::vector<SteamID> retVal;
+	retVal.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		retVal.emplace_back(uint32_t(10'000'000 + i * 16 + Roll(random, 0, 15)), SteamAccountType::Individual);
+
+	std::shuffle(retVal.begin(), retVal.end(), random);
+	return retVal;
+}
+
+std::string Bench::GeneratePlayerName(std::mt19937& random)
+{
+	std::string retVal;
+
+	const auto partCount = Roll(random, 1, 4);
+	for (size_t i = 0; i < partCount; i++)
+		retVal += Pick(random, NAME_PARTS);
+
+	if (Roll(random, 0, 1))
+		retVal += std::to_string(Roll(random, 0, 9999));
+
+	return retVal;
+}
+
+std::string Bench::GenerateChatMessage(std::mt19937& random)
+{
+	std::string retVal;
+
+	const auto wordCount = Roll(random, 1, 16);
+	for (size_t i = 0; i < wordCount; i++)
+	{
+		if (i > 0)
+			retVal += ' ';
+
+		retVal += Pick(random, CHAT_WORDS);
+	}
+
+	return retVal;
+}
+
+std::string Bench::GeneratePlayerListFile(const std::vector<SteamID>& ids, uint32_t seed)
+{
+	std::mt19937 random(seed);
+
+	static constexpr std::string_view ATTRIBUTES[] = { "cheater"sv, "suspicious"sv, "exploiter"sv, "racist"sv };
+
+	nlohmann::json players = nlohmann::json::array();
+	for (const auto& id : ids)
+	{
+		nlohmann::json attributes = nlohmann::json::array();
+		attributes.push_back(Pick(random, ATTRIBUTES));
+		if (Roll(random, 0, 4) == 0)
+			attributes.push_back(Pick(random, ATTRIBUTES));
+
+		nlohmann::json player =
+		{
+			{ "steamid", id },
+			{ "attributes", std::move(attributes) },
+			{ "last_seen",
+				{
+					{ "player_name", GeneratePlayerName(random) },
+					{ "time", 1'500'000'000 + Roll(random, 0, 200'000'000) },
+				}
+			},
+		};
+
+		if (Roll(random, 0, 9) == 0)
+			player["proof"] = { GenerateChatMessage(random) };
+
+		players.push_back(std::move(player));
+	}
+
+	const nlohmann::json file =
+	{
+		{ "$schema", "https://raw.githubusercontent.com/PazerOP/tf2_bot_detector/master/schemas/v3/playerlist.schema.json" },
+		{ "players", std::move(players) },
+	};
+
+	return file.dump(1, '\t');
+}
+
+std::vector<ModerationRule> Bench::GenerateRules(size_t count, uint32_t seed)
+{
+	std::mt19937 random(seed);
+
+	std::vector<ModerationRule> retVal;
+	retVal.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		auto& rule = retVal.emplace_back();
+		rule.m_Description = mh::format("Benchmark rule {}", i);
+		rule.m_Actions.m_Mark.push_back(PlayerAttribute::Cheater);
+
+		auto& triggers = rule.m_Triggers;
+		triggers.m_Mode = Roll(random, 0, 4) == 0 ? TriggerMatchMode::MatchAll : TriggerMatchMode::MatchAny;
+
+		const auto roll = Roll(random, 0, 99);
+		if (roll < 60)
+		{
+			triggers.m_UsernameTextMatch = GenerateTextMatch(random);
+		}
+		else if (roll < 80)
+		{
+			triggers.m_ChatMsgTextMatch = GenerateTextMatch(random);
+		}
+		else if (roll < 90)
+		{
+			triggers.m_PersonanameTextMatch = GenerateTextMatch(random);
+		}
+		else if (roll < 95)
+		{
+			triggers.m_UsernameTextMatch = GenerateTextMatch(random);
+			triggers.m_ChatMsgTextMatch = GenerateTextMatch(random);
+		}
+		else
+		{
+			triggers.m_AvatarMatches.push_back({ mh::format("{:040x}", random()) });
+		}
+	}
+
+	return retVal;
+}
+
+std::string Bench::GenerateConsoleLog(size_t lineCount, uint32_t seed)
+{
+	std::mt19937 random(seed);
+
+	const auto& wrappers = GetChatWrappers();
+	const auto ids = GenerateSteamIDs(24, seed);
+
+	std::string retVal = "\n";
+	retVal.reserve(lineCount * 96);
+
+	unsigned seconds = 0;
+	for (size_t i = 0; i < lineCount; i++)
+	{
+		if (Roll(random, 0, 3) == 0)
+			seconds++;
+
+		retVal += mh::format("10/18/2026 - {:02}:{:02}:{:02}: ", (seconds / 3600) % 24, (seconds / 60) % 60, seconds % 60);
+
+		const auto& id = ids[Roll(random, 0, ids.size() - 1)];
+
+		// Weighted roughly like a real log with the tool polling status every few seconds
+		switch (const auto roll = Roll(random, 0, 99); roll / 10)
+		{
+		case 0:
+		case 1:
+		case 2:
+			retVal += mh::format(R"(#    {} "{}"     {}    {:02}:{:02}    {}    0 active)", Roll(random, 2, 400),
+				GeneratePlayerName(random), id, Roll(random, 0, 59), Roll(random, 0, 59), Roll(random, 5, 200));
+			break;
+		case 3:
+			retVal += mh::format("  Member[{}] {}  team = {}  type = MATCH_PLAYER", Roll(random, 0, 23), id,
+				Roll(random, 0, 1) ? "TF_GC_TEAM_DEFENDERS" : "TF_GC_TEAM_INVADERS");
+			break;
+		case 4:
+			retVal += mh::format("{} killed {} with {}.{}", GeneratePlayerName(random), GeneratePlayerName(random),
+				Roll(random, 0, 1) ? "scattergun" : "tf_projectile_rocket", Roll(random, 0, 9) == 0 ? " (crit)" : "");
+			break;
+		case 5:
+			retVal += FormatChatLine(wrappers, Roll(random, 0, 1) ? ChatCategory::All : ChatCategory::Team,
+				GeneratePlayerName(random), GenerateChatMessage(random));
+			break;
+		case 6:
+			retVal += mh::format("{:4} ms : {}", Roll(random, 5, 200), GeneratePlayerName(random));
+			break;
+		case 7:
+			if (roll % 5 == 0)
+				retVal += mh::format("CTFLobbyShared: ID:{:016x}  24 member(s), 0 pending", random());
+			else if (roll % 5 == 1)
+				retVal += "hostname: Valve Matchmaking Server (Virginia iad-1/srcds150 #37)";
+			else if (roll % 5 == 2)
+				retVal += "map     : pl_upward at: 0 x, 0 y, 0 z";
+			else if (roll % 5 == 3)
+				retVal += mh::format("players : {} humans, 0 bots (32 max)", Roll(random, 1, 24));
+			else
+				retVal += mh::format("edicts  : {} used of 2048 max", Roll(random, 400, 2000));
+			break;
+		case 8:
+			retVal += mh::format("- latency: {}.{:03}, loss 0.000", Roll(random, 0, 1), Roll(random, 0, 999));
+			break;
+		default:
+			// Stuff we don't recognize, which has to fall through every parser
+			retVal += mh::format("Unknown command \"{}\"", GenerateChatMessage(random));
+			break;
+		}
+
+		retVal += '\n';
+	}
+
+	return retVal;
+}
+
+BenchPlayer::BenchPlayer(SteamID id, std::string name) :
+	m_SteamID(id), m_Name(std::move(name))
+{
+	SteamAPI::PlayerSummary summary;
+	summary.m_SteamID = id;
+	summary.m_Nickname = m_Name;
+	summary.m_AvatarHash = mh::format("{:040x}", id.ID64);
+	m_Summary = std::move(summary);
+}
+
+const IWorldState& BenchPlayer::GetWorld() const
+{
+	return GetWorldState();
+}
+
+mh::expected<duration_t> BenchPlayer::GetTF2Playtime() const
+{
+	return ErrorCode::LazyValueUninitialized;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Config/Rules.h"
+#include "GameData/IPlayer.h"
+#include "Networking/LogsTFAPI.h"
+#include "Networking/SteamAPI.h"
+#include "Networking/SteamHistoryAPI.h"
+#include "GenericErrors.h"
+#include "PlayerStatus.h"
+#include "SteamID.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	struct ChatWrappers;
+	class IWorldState;
+	class Settings;
+}
+
+// Shared state and synthetic data generators for the benchmarks. Everything is
+// generated from a fixed seed so runs are comparable.
+namespace tf2_bot_detector::Bench
+{
+	// Constructed on first use. Internet usage is always disabled.
+	Settings& GetSettings();
+	IWorldState& GetWorldState();
+
+	// Also installed into GetSettings(), so ConsoleLogParser recognizes chat lines
+	const ChatWrappers& GetChatWrappers();
+
+	std::vector<SteamID> GenerateSteamIDs(size_t count, uint32_t seed = 1);
+	std::string GeneratePlayerName(std::mt19937& random);
+	std::string GenerateChatMessage(std::mt19937& random);
+
+	// The text of a playerlist file (the same shape as playerlist.json) containing these players
+	std::string GeneratePlayerListFile(const std::vector<SteamID>& ids, uint32_t seed = 1);
+
+	// A mix of name, chat and avatar rules with the same shape as rules.official.json
+	std::vector<ModerationRule> GenerateRules(size_t count, uint32_t seed = 1);
+
+	// console.log contents with timestamps: status, lobby, kill, chat, net status and unrecognized lines
+	std::string GenerateConsoleLog(size_t lineCount, uint32_t seed = 1);
+
+	// A player that only knows its name, SteamID and summary
+	class BenchPlayer final : public IPlayer
+	{
+	public:
+		BenchPlayer(SteamID id, std::string name);
+
+		const IWorldState& GetWorld() const override;
+		const LobbyMember* GetLobbyMember() const override { return nullptr; }
+		std::string GetNameUnsafe() const override { return m_Name; }
+		SteamID GetSteamID() const override { return m_SteamID; }
+		const mh::expected<SteamAPI::PlayerSummary>& GetPlayerSummary() const override { return m_Summary; }
+		const mh::expected<SteamAPI::PlayerBans>& GetPlayerBans() const override { return m_Bans; }
+		const mh::expected<SteamHistoryAPI::PlayerSourceBanState>& GetPlayerSourceBanState() const override { return m_SourceBans; }
+		mh::expected<duration_t> GetTF2Playtime() const override;
+		bool IsFriend() const override { return false; }
+		std::optional<UserID_t> GetUserID() const override { return std::nullopt; }
+		PlayerStatusState GetConnectionState() const override { return PlayerStatusState::Active; }
+		time_point_t GetConnectionTime() const override { return {}; }
+		duration_t GetConnectedTime() const override { return {}; }
+		TFTeam GetTeam() const override { return TFTeam::Unknown; }
+		const PlayerScores& GetScores() const override { return m_Scores; }
+		uint16_t GetPing() const override { return 0; }
+		time_point_t GetLastStatusUpdateTime() const override { return {}; }
+		std::optional<time_point_t> GetEstimatedAccountCreationTime() const override { return std::nullopt; }
+		const mh::expected<LogsTFAPI::PlayerLogsInfo>& GetLogsInfo() const override { return m_LogsInfo; }
+		const mh::expected<SteamAPI::PlayerFriends>& GetFriendsInfo() const override { return m_Friends; }
+		const mh::expected<SteamAPI::PlayerInventoryInfo>& GetInventoryInfo() const override { return m_Inventory; }
+		duration_t GetActiveTime() const override { return {}; }
+		size_t GetApproxMemoryUsage() const override { return sizeof(*this); }
+
+	private:
+		SteamID m_SteamID;
+		std::string m_Name;
+		PlayerScores m_Scores;
+
+		mh::expected<SteamAPI::PlayerSummary> m_Summary = ErrorCode::LazyValueUninitialized;
+		mh::expected<SteamAPI::PlayerBans> m_Bans = ErrorCode::LazyValueUninitialized;
+		mh::expected<SteamHistoryAPI::PlayerSourceBanState> m_SourceBans = ErrorCode::LazyValueUninitialized;
+		mh::expected<LogsTFAPI::PlayerLogsInfo> m_LogsInfo = ErrorCode::LazyValueUninitialized;
+		mh::expected<SteamAPI::PlayerFriends> m_Friends = ErrorCode::LazyValueUninitialized;
+		mh::expected<SteamAPI::PlayerInventoryInfo> m_Inventory = ErrorCode::LazyValueUninitialized;
+	};
+}
@@ -0,0 +1,26 @@
+#include "Benchmarks.h"
+#include "Filesystem.h"
+#include "Log.h"
+
+#include <benchmark/benchmark.h>
+
+int tf2_bot_detector::RunBenchmarks(int argc, const char** argv) try
+{
+	IFilesystem::Get().Init();
+	ILogManager::GetInstance().Init();
+
+	// Google Benchmark wants a mutable argv
+	auto args = const_cast<char**>(argv);
+	benchmark::Initialize(&argc, args);
+	if (benchmark::ReportUnrecognizedArguments(argc, args))
+		return 1;
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
+catch (...)
+{
+	LogException(MH_SOURCE_LOCATION_CURRENT(), "Unhandled exception while running benchmarks");
+	return 1;
+}
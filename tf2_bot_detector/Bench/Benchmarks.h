@@ -0,0 +1,8 @@
+#pragma once
+
+namespace tf2_bot_detector
+{
+	// Runs the Google Benchmark suite headless (no window, no network access).
+	// Accepts the usual --benchmark_* command line arguments.
+	int RunBenchmarks(int argc, const char** argv);
+}
@@ -0,0 +1,123 @@
+#include "BenchData.h"
+#include "Config/ChatWrappers.h"
+#include "ConsoleLog/ChatWrapperMatcher.h"
+#include "ConsoleLog/ConsoleLogParser.h"
+#include "ConsoleLog/IConsoleLine.h"
+
+#include <benchmark/benchmark.h>
+#include <mh/text/format.hpp>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct ConsoleLineSample
+	{
+		ConsoleLineType m_Type;
+		std::string_view m_Text;
+	};
+
+	// One representative line for each type ParseConsoleLine can produce. Chat lines
+	// are handled by ConsoleLogParser before they get here, see BM_ChatWrapperMatcher.
+	static constexpr ConsoleLineSample CONSOLE_LINE_SAMPLES[] =
+	{
+		{ ConsoleLineType::Generic, "Unknown command \"gg lol nice shot medic pls push cart\""sv },
+		{ ConsoleLineType::Ping, "  45 ms : xXpyrobot1337Xx"sv },
+		{ ConsoleLineType::LobbyStatusFailed, "Failed to find lobby shared object"sv },
+		{ ConsoleLineType::LobbyChanged, "Lobby updated"sv },
+		{ ConsoleLineType::DifferingLobbyReceived, "Differing lobby received. Lobby: [A:1:1234567890:12345]/Match123456/Lobby1234567 CurrentlyAssigned: [A:1:1234567890:12345]/Match123456/Lobby1234567 ConnectedToMatchServer: 1 HasLobby: 1 AssignedMatchEnded: 0"sv },
+		{ ConsoleLineType::LobbyHeader, "CTFLobbyShared: ID:0001a2b3c4d5e6f7  24 member(s), 0 pending"sv },
+		{ ConsoleLineType::LobbyMember, "  Member[12] [U:1:123456789]  team = TF_GC_TEAM_DEFENDERS  type = MATCH_PLAYER"sv },
+		{ ConsoleLineType::PartyHeader, "TFParty: ID:1a2b3c4d5e  2 member(s)  LeaderID: [U:1:123456789]"sv },
+		{ ConsoleLineType::PlayerStatus, "#    321 \"xXpyrobot1337Xx\"     [U:1:123456789]    12:34    67    0 active"sv },
+		{ ConsoleLineType::PlayerStatusIP, "udp/ip  : 169.254.1.2:12345  (public ip: 1.2.3.4)"sv },
+		{ ConsoleLineType::PlayerStatusShort, "#12 - xXpyrobot1337Xx"sv },
+		{ ConsoleLineType::PlayerStatusCount, "players : 23 humans, 0 bots (32 max)"sv },
+		{ ConsoleLineType::PlayerStatusMapPosition, "map     : pl_upward at: 0 x, 0 y, 0 z"sv },
+		{ ConsoleLineType::PlayerStatusHostName, "hostname: Valve Matchmaking Server (Virginia iad-1/srcds150 #37)"sv },
+		{ ConsoleLineType::ClientReachedServerSpawn, "Client reached server_spawn."sv },
+		{ ConsoleLineType::KillNotification, "xXpyrobot1337Xx killed heavy medic with tf_projectile_rocket. (crit)"sv },
+		{ ConsoleLineType::SuicideNotification, "xXpyrobot1337Xx suicided."sv },
+		{ ConsoleLineType::CvarlistConvar, "tf_bot_quota                             : 0        : , \"sv\", \"rep\" : Determines the total number of tf bots in the game."sv },
+		{ ConsoleLineType::EdictUsage, "edicts  : 1234 used of 2048 max"sv },
+		{ ConsoleLineType::SplitPacket, "<-- [cl ] Split packet    1/   3 seq 12345 size 1260 mtu 1260 from 169.254.1.2:12345"sv },
+		{ ConsoleLineType::SVC_UserMessage, "Msg from 169.254.1.2:12345: svc_UserMessage: type 4, bytes 64"sv },
+		{ ConsoleLineType::ConfigExec, "'autoexec.cfg' not present; not executing."sv },
+		{ ConsoleLineType::TeamsSwitched, "Teams have been switched."sv },
+		{ ConsoleLineType::Connecting, "Connecting to 169.254.1.2:12345..."sv },
+		{ ConsoleLineType::HostNewGame, "---- Host_NewGame ----"sv },
+		{ ConsoleLineType::GameQuit, "CTFGCClientSystem::ShutdownGC"sv },
+		{ ConsoleLineType::QueueStateChange, "[PartyClient] Requesting queue for 12v12 Casual Match"sv },
+		{ ConsoleLineType::InQueue, "    MatchGroup: 7  Started matchmaking: Sun Oct 18 12:00:00 2026  (12 seconds ago, now is Sun Oct 18 12:00:12 2026)"sv },
+		{ ConsoleLineType::ServerDroppedPlayer, "Dropped xXpyrobot1337Xx from server (Disconnect by user.)"sv },
+		{ ConsoleLineType::NetStatusConfig, "- Config: Multiplayer, dedicated, 24 connections"sv },
+		{ ConsoleLineType::NetLatency, "- Latency: avg out 0.04s, in 0.05s"sv },
+		{ ConsoleLineType::NetLoss, "- Loss:    avg out 0.0, in 0.0"sv },
+		{ ConsoleLineType::NetPacketsTotal, "- Packets: net total out  66.0/s, in 66.0/s"sv },
+		{ ConsoleLineType::NetDataTotal, "- Data:    net total out  12.3, in 45.6 kB/s"sv },
+		{ ConsoleLineType::NetChannelLatencyLoss, "- latency: 0.045, loss 0.000"sv },
+		{ ConsoleLineType::NetChannelPackets, "- packets: in 66.0/s, out 66.0/s"sv },
+		{ ConsoleLineType::NetChannelChoke, "- choke: in 0.00, out 0.00"sv },
+		{ ConsoleLineType::NetChannelFlow, "- flow: in 12.3, out 4.5 kB/s"sv },
+		{ ConsoleLineType::NetChannelTotal, "- total: in 12.3, out 4.5 MB"sv },
+	};
+
+	void BM_ParseConsoleLine(benchmark::State& state)
+	{
+		const auto& sample = CONSOLE_LINE_SAMPLES[state.range(0)];
+		auto& world = Bench::GetWorldState();
+
+		state.SetLabel(std::string(to_string_view(sample.m_Type)));
+
+		// Make sure we're measuring the parser we think we are
+		if (auto parsed = IConsoleLine::ParseConsoleLine(sample.m_Text, {}, world);
+			!parsed || parsed->GetType() != sample.m_Type)
+		{
+			state.SkipWithError(mh::format("Sample parsed as {}",
+				parsed ? to_string_view(parsed->GetType()) : "nothing"sv).c_str());
+			return;
+		}
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(IConsoleLine::ParseConsoleLine(sample.m_Text, {}, world));
+	}
+	BENCHMARK(BM_ParseConsoleLine)->DenseRange(0, int(std::size(CONSOLE_LINE_SAMPLES)) - 1);
+
+	void BM_ChatWrapperMatcher(benchmark::State& state)
+	{
+		const auto& wrappers = Bench::GetChatWrappers();
+		const auto& type = wrappers.m_Types[size_t(ChatCategory::All)];
+
+		const std::string line = mh::format("{}{}xXpyrobot1337Xx{} :  {}gg lol nice shot medic pls push cart{}{}",
+			type.m_Full.m_Start.m_Narrow, type.m_Name.m_Start.m_Narrow, type.m_Name.m_End.m_Narrow,
+			type.m_Message.m_Start.m_Narrow, type.m_Message.m_End.m_Narrow, type.m_Full.m_End.m_Narrow);
+
+		ChatWrapperMatcher matcher;
+		matcher.Rebuild(wrappers);
+
+		for (auto _ : state)
+		{
+			ChatWrapperMatcher::Match match;
+			benchmark::DoNotOptimize(matcher.TryMatch(line, match));
+			benchmark::DoNotOptimize(match);
+		}
+	}
+	BENCHMARK(BM_ChatWrapperMatcher);
+
+	void BM_ConsoleLogParser_ParseText(benchmark::State& state)
+	{
+		const auto lineCount = size_t(state.range(0));
+		const auto log = Bench::GenerateConsoleLog(lineCount);
+
+		for (auto _ : state)
+		{
+			ConsoleLogParser parser(Bench::GetWorldState(), Bench::GetSettings(), {});
+			parser.ParseText(log);
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * log.size()));
+		state.SetItemsProcessed(int64_t(state.iterations() * lineCount));
+	}
+	BENCHMARK(BM_ConsoleLogParser_ParseText)->RangeMultiplier(10)->Range(1'000, 100'000)->Unit(benchmark::kMillisecond);
+}
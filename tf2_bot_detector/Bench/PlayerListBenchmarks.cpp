@@ -0,0 +1,128 @@
+#include "BenchData.h"
+#include "Config/PlayerListJSON.h"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// PlayerListJSON::PlayerListFile is private, but we can still get at it through the group
+	using PlayerListFile = decltype(std::declval<PlayerListJSON&>().GetConfigFileGroup().m_UserList)::value_type;
+
+	// A PlayerListJSON whose only contents are count synthetic players. Building the
+	// big ones takes a while, so they're kept around for every benchmark that uses them.
+	const PlayerListJSON& GetPlayerList(size_t count)
+	{
+		static std::map<size_t, std::unique_ptr<PlayerListJSON>> s_PlayerLists;
+
+		auto& playerList = s_PlayerLists[count];
+		if (!playerList)
+		{
+			playerList = std::make_unique<PlayerListJSON>(Bench::GetSettings());
+
+			// Don't let whatever is in the user's cfg folder affect the results
+			auto& group = playerList->GetConfigFileGroup();
+			group.m_OfficialList.get(); // Let the initial load finish before replacing it
+			group.m_ThirdPartyLists.get();
+			group.m_OfficialList = mh::make_ready_task<PlayerListFile>();
+			group.m_ThirdPartyLists = mh::make_ready_task<std::remove_reference_t<decltype(group)>::collection_type>();
+
+			auto& file = group.m_UserList.emplace();
+			for (const auto& id : Bench::GenerateSteamIDs(count))
+				file.GetOrAddPlayer(id).m_SavedAttributes = PlayerAttribute::Cheater;
+		}
+
+		return *playerList;
+	}
+
+	void BM_PlayerList_Load(benchmark::State& state)
+	{
+		const auto count = size_t(state.range(0));
+		const auto text = Bench::GeneratePlayerListFile(Bench::GenerateSteamIDs(count));
+
+		for (auto _ : state)
+		{
+			PlayerListFile file;
+			file.Deserialize(nlohmann::json::parse(text));
+			benchmark::DoNotOptimize(file.size());
+		}
+
+		state.SetBytesProcessed(int64_t(state.iterations() * text.size()));
+		state.SetItemsProcessed(int64_t(state.iterations() * count));
+	}
+	BENCHMARK(BM_PlayerList_Load)->RangeMultiplier(10)->Range(10'000, 1'000'000)->Unit(benchmark::kMillisecond);
+
+	// Alternates between players that are in the list and players that aren't
+	template<typename TFunc>
+	void RunPlayerListLookup(benchmark::State& state, TFunc&& func)
+	{
+		const auto count = size_t(state.range(0));
+		const auto& playerList = GetPlayerList(count);
+
+		const auto present = Bench::GenerateSteamIDs(count);
+
+		// Below the range GenerateSteamIDs() uses
+		std::vector<SteamID> absent;
+		for (uint32_t i = 0; i < 1024; i++)
+			absent.emplace_back(5'000'000 + i, SteamAccountType::Individual);
+
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			const auto& id = (index & 1) ? absent[(index / 2) % absent.size()] : present[(index / 2) % present.size()];
+			benchmark::DoNotOptimize(func(playerList, id));
+			index++;
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+
+	void BM_PlayerList_GetPlayerAttributes(benchmark::State& state)
+	{
+		RunPlayerListLookup(state, [](const PlayerListJSON& playerList, const SteamID& id)
+			{
+				return playerList.GetPlayerAttributes(id);
+			});
+	}
+	BENCHMARK(BM_PlayerList_GetPlayerAttributes)->RangeMultiplier(10)->Range(10'000, 1'000'000);
+
+	void BM_PlayerList_HasPlayerAttributes(benchmark::State& state)
+	{
+		RunPlayerListLookup(state, [](const PlayerListJSON& playerList, const SteamID& id)
+			{
+				return playerList.HasPlayerAttributes(id, { PlayerAttribute::Cheater, PlayerAttribute::Exploiter });
+			});
+	}
+	BENCHMARK(BM_PlayerList_HasPlayerAttributes)->RangeMultiplier(10)->Range(10'000, 1'000'000);
+
+	// A typical friends list, about a third of which is on the list
+	void BM_PlayerList_CountMarkedAccounts(benchmark::State& state)
+	{
+		const auto count = size_t(state.range(0));
+		const auto& playerList = GetPlayerList(count);
+
+		const auto present = Bench::GenerateSteamIDs(count);
+
+		std::vector<uint32_t> friends;
+		for (size_t i = 0; i < 100; i++)
+			friends.push_back(present[(i * 7919) % present.size()].GetAccountID());
+		for (uint32_t i = 0; i < 200; i++)
+			friends.push_back(5'000'000 + i);
+
+		std::sort(friends.begin(), friends.end());
+		friends.erase(std::unique(friends.begin(), friends.end()), friends.end());
+
+		for (auto _ : state)
+			benchmark::DoNotOptimize(playerList.CountMarkedAccounts(friends));
+
+		state.SetItemsProcessed(int64_t(state.iterations() * friends.size()));
+	}
+	BENCHMARK(BM_PlayerList_CountMarkedAccounts)->RangeMultiplier(10)->Range(10'000, 1'000'000);
+}
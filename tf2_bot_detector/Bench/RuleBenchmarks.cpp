@@ -0,0 +1,73 @@
+#include "BenchData.h"
+#include "Config/Rules.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::vector<Bench::BenchPlayer> GeneratePlayers(size_t count)
+	{
+		std::mt19937 random(2);
+		const auto ids = Bench::GenerateSteamIDs(count, 2);
+
+		std::vector<Bench::BenchPlayer> retVal;
+		retVal.reserve(count);
+		for (const auto& id : ids)
+			retVal.emplace_back(id, Bench::GeneratePlayerName(random));
+
+		return retVal;
+	}
+
+	// Every rule against one player, the way ModeratorLogic does when a player joins
+	void BM_ModerationRule_MatchPlayer(benchmark::State& state)
+	{
+		const auto rules = Bench::GenerateRules(size_t(state.range(0)));
+		const auto players = GeneratePlayers(64);
+
+		size_t playerIndex = 0;
+		for (auto _ : state)
+		{
+			const auto& player = players[playerIndex++ % players.size()];
+
+			size_t matches = 0;
+			for (const auto& rule : rules)
+				matches += rule.Match(player);
+
+			benchmark::DoNotOptimize(matches);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * rules.size()));
+	}
+	BENCHMARK(BM_ModerationRule_MatchPlayer)->RangeMultiplier(10)->Range(100, 10'000);
+
+	// Every rule against one chat message
+	void BM_ModerationRule_MatchChat(benchmark::State& state)
+	{
+		const auto rules = Bench::GenerateRules(size_t(state.range(0)));
+		const auto players = GeneratePlayers(64);
+
+		std::mt19937 random(3);
+		std::vector<std::string> messages(64);
+		for (auto& message : messages)
+			message = Bench::GenerateChatMessage(random);
+
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			const auto& player = players[index % players.size()];
+			const auto& message = messages[index % messages.size()];
+			index++;
+
+			size_t matches = 0;
+			for (const auto& rule : rules)
+				matches += rule.Match(player, message);
+
+			benchmark::DoNotOptimize(matches);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * rules.size()));
+	}
+	BENCHMARK(BM_ModerationRule_MatchChat)->RangeMultiplier(10)->Range(100, 10'000);
+}
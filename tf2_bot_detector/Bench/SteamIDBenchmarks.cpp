@@ -0,0 +1,26 @@
+#include "SteamID.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	void BM_SteamID_Parse(benchmark::State& state, std::string_view text)
+	{
+		for (auto _ : state)
+			benchmark::DoNotOptimize(SteamID(text));
+	}
+	BENCHMARK_CAPTURE(BM_SteamID_Parse, SteamID3, "[U:1:123456789]"sv);
+	BENCHMARK_CAPTURE(BM_SteamID_Parse, SteamID64, "76561198083722517"sv);
+	BENCHMARK_CAPTURE(BM_SteamID_Parse, SteamID2, "STEAM_0:1:61728394"sv);
+
+	void BM_SteamID_Format(benchmark::State& state)
+	{
+		const SteamID id(123456789, SteamAccountType::Individual);
+		for (auto _ : state)
+			benchmark::DoNotOptimize(id.str());
+	}
+	BENCHMARK(BM_SteamID_Format);
+}
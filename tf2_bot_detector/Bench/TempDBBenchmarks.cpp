@@ -0,0 +1,183 @@
+#include "BenchData.h"
+#include "DB/TempDB.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+using namespace tf2_bot_detector::DB;
+
+namespace
+{
+	static constexpr size_t PREFILLED_COUNT = 10'000;
+
+	// A fresh database in the system temp dir, so we never touch the real cache
+	ITempDB& GetTempDB()
+	{
+		static const std::unique_ptr<ITempDB> s_TempDB = []
+		{
+			const auto path = std::filesystem::temp_directory_path() / "tf2bd_bench_db.sqlite";
+			for (const char* suffix : { "", "-wal", "-shm" })
+			{
+				std::error_code ec;
+				std::filesystem::remove(path.string() + suffix, ec);
+			}
+
+			return ITempDB::Create(path);
+		}();
+
+		return *s_TempDB;
+	}
+
+	const std::vector<SteamID>& GetPrefilledIDs()
+	{
+		static const std::vector<SteamID> s_IDs = []
+		{
+			auto ids = Bench::GenerateSteamIDs(PREFILLED_COUNT, 3);
+
+			auto& db = GetTempDB();
+			for (const auto& id : ids)
+			{
+				AccountAgeInfo ageInfo;
+				ageInfo.m_SteamID = id;
+				ageInfo.m_CreationTime = time_point_t(std::chrono::seconds(1'200'000'000 + id.GetAccountID()));
+				db.Store(ageInfo);
+
+				LogsTFCacheInfo logsInfo;
+				logsInfo.m_ID = id;
+				logsInfo.m_LogsCount = id.GetAccountID() % 1000;
+				logsInfo.m_LastCacheUpdateTime = tfbd_clock_t::now();
+				db.Store(logsInfo);
+
+				// Everyone is friends with the next 200 accounts, like a tightly knit bot network
+				AccountFriendsListInfo friendsInfo;
+				friendsInfo.m_SteamID = id;
+				friendsInfo.m_LastCacheUpdateTime = tfbd_clock_t::now();
+				for (uint32_t i = 1; i <= 200; i++)
+					friendsInfo.m_Friends.insert(SteamID(id.GetAccountID() + i, SteamAccountType::Individual));
+				db.Store(friendsInfo);
+			}
+
+			return ids;
+		}();
+
+		return s_IDs;
+	}
+
+	void BM_TempDB_StoreAccountAge(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+
+		// Above the range GenerateSteamIDs() uses, so these are always inserts
+		uint32_t accountID = 1'000'000'000;
+		for (auto _ : state)
+		{
+			AccountAgeInfo info;
+			info.m_SteamID = SteamID(accountID++, SteamAccountType::Individual);
+			info.m_CreationTime = tfbd_clock_t::now();
+			db.Store(info);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+	BENCHMARK(BM_TempDB_StoreAccountAge);
+
+	void BM_TempDB_TryGetAccountAge(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+		const auto& ids = GetPrefilledIDs();
+
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			AccountAgeInfo info;
+			info.m_SteamID = ids[index++ % ids.size()];
+			benchmark::DoNotOptimize(db.TryGet(info));
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+	BENCHMARK(BM_TempDB_TryGetAccountAge);
+
+	void BM_TempDB_GetNearestAccountAgeInfos(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+		const auto& ids = GetPrefilledIDs();
+
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			// Just past a known ID, so there's always a lower and (usually) an upper neighbor
+			const auto& known = ids[index++ % ids.size()];
+			const SteamID id(known.GetAccountID() + 1, SteamAccountType::Individual);
+
+			std::optional<AccountAgeInfo> lower, upper;
+			db.GetNearestAccountAgeInfos(id, lower, upper);
+			benchmark::DoNotOptimize(lower);
+			benchmark::DoNotOptimize(upper);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+	BENCHMARK(BM_TempDB_GetNearestAccountAgeInfos);
+
+	void BM_TempDB_StoreLogsTF(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+		const auto& ids = GetPrefilledIDs();
+
+		// Existing rows, like refreshing an expired cache entry
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			LogsTFCacheInfo info;
+			info.m_ID = ids[index++ % ids.size()];
+			info.m_LogsCount = uint32_t(index);
+			info.m_LastCacheUpdateTime = tfbd_clock_t::now();
+			db.Store(info);
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+	BENCHMARK(BM_TempDB_StoreLogsTF);
+
+	void BM_TempDB_TryGetLogsTF(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+		const auto& ids = GetPrefilledIDs();
+
+		size_t index = 0;
+		for (auto _ : state)
+		{
+			LogsTFCacheInfo info;
+			info.m_ID = ids[index++ % ids.size()];
+			benchmark::DoNotOptimize(db.TryGet(info));
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations()));
+	}
+	BENCHMARK(BM_TempDB_TryGetLogsTF);
+
+	// A 300 entry friends list, two thirds of which have cached friends lists of their own
+	void BM_TempDB_GetCachedFriendAccountIDs(benchmark::State& state)
+	{
+		auto& db = GetTempDB();
+		const auto& ids = GetPrefilledIDs();
+
+		std::vector<uint32_t> friends;
+		for (size_t i = 0; i < 200; i++)
+			friends.push_back(ids[(i * 7919) % ids.size()].GetAccountID());
+		for (uint32_t i = 0; i < 100; i++)
+			friends.push_back(5'000'000 + i);
+
+		std::vector<uint32_t> friendsOfFriends;
+		for (auto _ : state)
+		{
+			friendsOfFriends.clear();
+			benchmark::DoNotOptimize(db.GetCachedFriendAccountIDs(friends, friendsOfFriends));
+		}
+
+		state.SetItemsProcessed(int64_t(state.iterations() * friends.size()));
+	}
+	BENCHMARK(BM_TempDB_GetCachedFriendAccountIDs)->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,6 @@
+#include "Benchmarks.h"
+
+int main(int argc, const char** argv)
+{
+	return tf2_bot_detector::RunBenchmarks(argc, argv);
+}
@@ -42,3 +42,23 @@ void Bitmap::LoadFile(const std::filesystem::path& path, uint8_t desiredChannels
 	if (!m_Image)
 		throw std::runtime_error("Failed to load image from "s << path << ": " << stbi_failure_reason());
 }
+
+void Bitmap::LoadMemory(const std::string_view& data)
+{
+	return LoadMemory(data, 0);
+}
+
+void Bitmap::LoadMemory(const std::string_view& data, uint8_t desiredChannels)
+{
+	int width, height, channels;
+	m_Image.reset(reinterpret_cast<std::byte*>(stbi_load_from_memory(
+		reinterpret_cast<const stbi_uc*>(data.data()), static_cast<int>(data.size()),
+		&width, &height, &channels, desiredChannels)));
+
+	m_Width = width;
+	m_Height = height;
+	m_Channels = channels;
+
+	if (!m_Image)
+		throw std::runtime_error("Failed to load image from memory: "s << stbi_failure_reason());
+}
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <filesystem>
+#include <string_view>
 
 namespace tf2_bot_detector
 {
@@ -15,6 +16,10 @@ namespace tf2_bot_detector
 		void LoadFile(const std::filesystem::path& path);
 		void LoadFile(const std::filesystem::path& path, uint8_t desiredChannels);
 
+		// Decodes an image that has already been read into memory (png, jpg, etc)
+		void LoadMemory(const std::string_view& data);
+		void LoadMemory(const std::string_view& data, uint8_t desiredChannels);
+
 		const void* GetData() const { return m_Image.get(); }
 		uint32_t GetHeight() const { return m_Height; }
 		uint32_t GetWidth() const { return m_Width; }
@@ -1,6 +1,7 @@
 #define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING 1
 
 #include "ChatWrappers.h"
+#include "LocalizationTokens.h"
 #include "Util/JSONUtils.h"
 #include "Util/TextUtils.h"
 #include "Log.h"
@@ -186,6 +187,8 @@ static void RegexSmartReplace(std::string& str, const std::regex& regex, TFunc&&
 	}
 }
 
+static constexpr auto TF_CHAT_ROOT = "TF_Chat_"sv;
+
 static bool GetChatCategory(const std::string* src, std::string_view* name, ChatCategory* category, bool* isEnglish)
 {
 	if (!src)
@@ -194,8 +197,6 @@ static bool GetChatCategory(const std::string* src, std::string_view* name, Chat
 		return false;
 	}
 
-	static constexpr auto TF_CHAT_ROOT = "TF_Chat_"sv;
-
 	std::string_view localName;
 	if (!name)
 		name = &localName;
@@ -240,39 +241,24 @@ static bool GetChatCategory(const std::string* src, std::string_view* name, Chat
 	return true;
 }
 
-static void GetChatMsgFormats(const std::string_view& debugInfo, const std::string_view& translations, ChatFormatStrings& strings)
+static void GetChatMsgFormats(const std::string_view& debugInfo, const LocalizationTokens& tokens, ChatFormatStrings& strings)
 {
-	assert(!translations.empty());
-
-	const char* begin = translations.data();
-	const char* end = begin + translations.size();
-	std::error_code ec;
-	auto parsed = tyti::vdf::read(begin, end, ec);
-	if (ec)
-	{
-		LogError("Failed to parse translations from "s << std::quoted(debugInfo) << ": " << ec);
-		return;
-	}
+	std::string_view chatType;
+	bool isEnglish;
 
-	if (auto tokens = parsed.childs["Tokens"])
+	for (const auto& attrib : tokens)
 	{
-		std::string_view chatType;
-		bool isEnglish;
+		ChatCategory cat;
+		if (!GetChatCategory(&attrib.first, &chatType, &cat, &isEnglish))
+			continue;
 
-		for (const auto& attrib : tokens->attribs)
+		if (attrib.second.empty())
 		{
-			ChatCategory cat;
-			if (!GetChatCategory(&attrib.first, &chatType, &cat, &isEnglish))
-				continue;
-
-			if (attrib.second.empty())
-			{
-				LogWarning(MH_SOURCE_LOCATION_CURRENT(), "{}: Empty value read for {} ({})",
-					std::quoted(debugInfo), std::quoted(attrib.first), mh::enum_fmt(cat));
-			}
-
-			(isEnglish ? strings.m_English : strings.m_Localized)[(int)cat] = attrib.second;
+			LogWarning(MH_SOURCE_LOCATION_CURRENT(), "{}: Empty value read for {} ({})",
+				std::quoted(debugInfo), std::quoted(attrib.first), mh::enum_fmt(cat));
 		}
+
+		(isEnglish ? strings.m_English : strings.m_Localized)[(int)cat] = attrib.second;
 	}
 }
 
@@ -358,24 +344,21 @@ static std::filesystem::path FindExistingChatTranslationFile(
 	return {};
 }
 
-#include <stdio.h>
-
-static ChatFormatStrings FindExistingTranslations(const std::filesystem::path& tfdir, const std::string_view& language)
+static ChatFormatStrings FindExistingTranslations(const std::filesystem::path& tfdir, const std::string_view& language,
+	ILocalizationTokenCache& tokenCache)
 {
 	ChatFormatStrings retVal;
 
-	for (const auto& filename : GetLocalizationFiles(tfdir, language)) {
-		std::string translationData;
-
-		try {
-			translationData = ToMB(ReadWideFile(filename));
+	for (const auto& filename : GetLocalizationFiles(tfdir, language))
+	{
+		try
+		{
+			GetChatMsgFormats(filename.string(), tokenCache.GetTokens(filename), retVal);
 		}
-		catch (std::runtime_error) {
-			LogException("Attempting to parse as-is");
-			translationData = IFilesystem::Get().ReadFile(filename);
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to read translations from {}", filename);
 		}
-
-		GetChatMsgFormats(filename.string(), translationData, retVal);
 	}
 
 	return retVal;
@@ -645,6 +628,9 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 	ChatFmtStrLengths translationLengths;
 
 	{
+		const auto tokenCache = ILocalizationTokenCache::Create(
+			IFilesystem::Get().GetTempDir() / "localization_token_cache.json", std::string(TF_CHAT_ROOT));
+
 		std::mutex lengthsMutex;
 
 		// Get all the existing translations
@@ -652,7 +638,7 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 			[&](const std::string_view& lang)
 			{
 				const size_t index = &lang - std::begin(LANGUAGES);
-				const auto& localTrans = translations[index] = FindExistingTranslations(tfdir, lang);
+				const auto& localTrans = translations[index] = FindExistingTranslations(tfdir, lang, *tokenCache);
 
 				ChatFmtStrLengths localLengths;
 
@@ -673,6 +659,8 @@ ChatWrappers tf2_bot_detector::RandomizeChatWrappers(const std::filesystem::path
 
 				IncrementProgress();
 			});
+
+		tokenCache->Save();
 	}
 
 	ChatWrappers wrappers(translationLengths);
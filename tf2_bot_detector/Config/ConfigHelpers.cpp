@@ -14,8 +14,13 @@
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <thread>
 
+using namespace std::chrono_literals;
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 using namespace tf2_bot_detector;
@@ -54,9 +59,181 @@ auto tf2_bot_detector::GetConfigFilePaths(const std::string_view& basename) -> C
 	return retVal;
 }
 
-static void SaveJSONToFile(const std::filesystem::path& filename, const nlohmann::json& json)
+namespace
 {
-	IFilesystem::Get().WriteFile(filename, json.dump(1, '\t', true, nlohmann::detail::error_handler_t::ignore) << '\n', PathUsage::WriteRoaming);
+	// Owns every write to a config file, so that saves which wouldn't change anything can be
+	// skipped, and so the UI can save on every little change without waiting on the disk.
+	class ConfigFileWriter final
+	{
+	public:
+		static ConfigFileWriter& Get();
+
+		~ConfigFileWriter();
+
+		// Written on the writer thread after COALESCE_DELAY. Only the last contents queued
+		// for a path during that time are written.
+		void QueueWrite(std::filesystem::path path, std::string contents);
+
+		// Written immediately, replacing anything queued for the same path. Throws on failure.
+		void Write(const std::filesystem::path& path, std::string contents);
+
+		// Writes everything queued so far on the calling thread, without waiting for COALESCE_DELAY
+		void WritePendingWrites();
+
+	private:
+		ConfigFileWriter();
+
+		struct PendingWrite
+		{
+			std::string m_Contents;
+			size_t m_Hash{};
+		};
+
+		void WriterThreadFunc();
+		void WriteFile(const std::filesystem::path& path, const PendingWrite& write);
+
+		std::mutex m_WriteMutex;   // Held while writing, and while taking writes out of m_PendingWrites
+		std::mutex m_StateMutex;
+		std::condition_variable m_WakeCV;
+		std::map<std::filesystem::path, PendingWrite> m_PendingWrites;
+
+		// Hash of what will be on disk once any write in progress finishes. Recorded before
+		// the write starts, so a save queued during a write is compared to what's being
+		// written rather than to what was there before it.
+		std::map<std::filesystem::path, size_t> m_WrittenHashes;
+		bool m_StopRequested = false;
+		std::thread m_WriterThread;
+
+		// Long enough to cover dragging a slider or color picker around
+		static constexpr auto COALESCE_DELAY = 500ms;
+	};
+
+	ConfigFileWriter& ConfigFileWriter::Get()
+	{
+		static ConfigFileWriter s_Writer;
+		return s_Writer;
+	}
+
+	ConfigFileWriter::ConfigFileWriter()
+	{
+		// Make sure the filesystem outlives us, since we still write anything pending on shutdown
+		IFilesystem::Get();
+
+		m_WriterThread = std::thread(&ConfigFileWriter::WriterThreadFunc, this);
+	}
+
+	ConfigFileWriter::~ConfigFileWriter()
+	{
+		{
+			std::lock_guard lock(m_StateMutex);
+			m_StopRequested = true;
+		}
+
+		m_WakeCV.notify_one();
+		m_WriterThread.join();
+
+		// The writer thread may already be gone without having run (threads are killed
+		// before statics are destroyed when a dll is unloaded), so make sure nothing is lost
+		WritePendingWrites();
+	}
+
+	void ConfigFileWriter::QueueWrite(std::filesystem::path path, std::string contents)
+	{
+		const auto hash = std::hash<std::string>{}(contents);
+
+		{
+			std::lock_guard lock(m_StateMutex);
+			if (auto found = m_WrittenHashes.find(path); found != m_WrittenHashes.end() && found->second == hash)
+			{
+				// Back to what's already on (or being written to) disk
+				m_PendingWrites.erase(path);
+				return;
+			}
+
+			m_PendingWrites.insert_or_assign(std::move(path), PendingWrite{ std::move(contents), hash });
+		}
+
+		m_WakeCV.notify_one();
+	}
+
+	void ConfigFileWriter::Write(const std::filesystem::path& path, std::string contents)
+	{
+		const auto hash = std::hash<std::string>{}(contents);
+		const PendingWrite write{ std::move(contents), hash };
+
+		std::lock_guard writeLock(m_WriteMutex);
+		{
+			std::lock_guard lock(m_StateMutex);
+			m_PendingWrites.erase(path);
+
+			if (auto found = m_WrittenHashes.find(path); found != m_WrittenHashes.end() && found->second == write.m_Hash)
+				return;
+
+			m_WrittenHashes.insert_or_assign(path, write.m_Hash);
+		}
+
+		WriteFile(path, write);
+	}
+
+	void ConfigFileWriter::WriteFile(const std::filesystem::path& path, const PendingWrite& write)
+	{
+		try
+		{
+			IFilesystem::Get().WriteFile(path, write.m_Contents, PathUsage::WriteRoaming);
+		}
+		catch (...)
+		{
+			// We don't know what's on disk anymore, so the next save shouldn't be skipped
+			std::lock_guard lock(m_StateMutex);
+			m_WrittenHashes.erase(path);
+			throw;
+		}
+	}
+
+	void ConfigFileWriter::WriterThreadFunc()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_StateMutex);
+				m_WakeCV.wait(lock, [&] { return m_StopRequested || !m_PendingWrites.empty(); });
+
+				if (m_StopRequested && m_PendingWrites.empty())
+					break;
+
+				// Give whoever is saving a chance to finish before we write anything
+				m_WakeCV.wait_for(lock, COALESCE_DELAY, [&] { return m_StopRequested; });
+			}
+
+			WritePendingWrites();
+		}
+	}
+
+	void ConfigFileWriter::WritePendingWrites()
+	{
+		std::lock_guard writeLock(m_WriteMutex);
+		decltype(m_PendingWrites) writes;
+		{
+			std::lock_guard lock(m_StateMutex);
+			writes.swap(m_PendingWrites);
+
+			for (const auto& [path, write] : writes)
+				m_WrittenHashes.insert_or_assign(path, write.m_Hash);
+		}
+
+		for (const auto& [path, write] : writes)
+		{
+			try
+			{
+				WriteFile(path, write);
+				DebugLog("Saved {}", path);
+			}
+			catch (...)
+			{
+				LogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to write {}", path);
+			}
+		}
+	}
 }
 
 static ConfigSchemaInfo LoadAndValidateSchema(const ConfigFileBase& config, const nlohmann::json& json)
@@ -369,7 +546,7 @@ mh::task<std::error_condition> ConfigFileBase::LoadFileInternalAsync(std::filesy
 	co_return ConfigErrorType::Success;
 }
 
-std::error_condition tf2_bot_detector::ConfigFileBase::SaveFile(const std::filesystem::path& filename) const
+std::error_condition ConfigFileBase::SerializeFile(const std::filesystem::path& filename, std::string& contents) const
 {
 	nlohmann::json json;
 
@@ -406,9 +583,19 @@ std::error_condition tf2_bot_detector::ConfigFileBase::SaveFile(const std::files
 		return ConfigErrorType::SerializedSchemaValidationFailed;
 	}
 
+	contents = json.dump(1, '\t', true, nlohmann::detail::error_handler_t::ignore) << '\n';
+	return ConfigErrorType::Success;
+}
+
+std::error_condition tf2_bot_detector::ConfigFileBase::SaveFile(const std::filesystem::path& filename) const
+{
+	std::string contents;
+	if (auto err = SerializeFile(filename, contents))
+		return err;
+
 	try
 	{
-		SaveJSONToFile(filename, json);
+		ConfigFileWriter::Get().Write(IFilesystem::Get().ResolvePath(filename, PathUsage::WriteRoaming), std::move(contents));
 	}
 	catch (...)
 	{
@@ -419,6 +606,30 @@ std::error_condition tf2_bot_detector::ConfigFileBase::SaveFile(const std::files
 	return ConfigErrorType::Success;
 }
 
+std::error_condition ConfigFileBase::SaveFileDeferred(const std::filesystem::path& filename) const
+{
+	std::string contents;
+	if (auto err = SerializeFile(filename, contents))
+		return err;
+
+	try
+	{
+		ConfigFileWriter::Get().QueueWrite(IFilesystem::Get().ResolvePath(filename, PathUsage::WriteRoaming), std::move(contents));
+	}
+	catch (...)
+	{
+		LogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to queue write of {}", filename);
+		return ConfigErrorType::WriteFileFailed;
+	}
+
+	return ConfigErrorType::Success;
+}
+
+void ConfigFileBase::FlushDeferredSaves()
+{
+	ConfigFileWriter::Get().WritePendingWrites();
+}
+
 void ConfigFileBase::Serialize(nlohmann::json& json) const
 {
 	json.clear();
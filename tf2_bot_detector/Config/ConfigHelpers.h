@@ -91,6 +91,13 @@ namespace tf2_bot_detector
 		mh::task<std::error_condition> LoadFileAsync(const std::filesystem::path& filename, std::shared_ptr<const IHTTPClient> client = nullptr);
 		std::error_condition SaveFile(const std::filesystem::path& filename) const;
 
+		// Serializes immediately, but leaves the write to a background thread. Saves that wouldn't
+		// change the file are skipped, and a burst of saves to the same file only writes the last one.
+		std::error_condition SaveFileDeferred(const std::filesystem::path& filename) const;
+
+		// Writes anything SaveFileDeferred() still has queued, on the calling thread
+		static void FlushDeferredSaves();
+
 		virtual void ValidateSchema(const ConfigSchemaInfo& schema) const = 0 {}
 		virtual void Deserialize(const nlohmann::json& json) = 0 {}
 		virtual void Serialize(nlohmann::json& json) const = 0;
@@ -103,6 +110,7 @@ namespace tf2_bot_detector
 		virtual void PostLoad(bool deserialized) {}
 
 	private:
+		std::error_condition SerializeFile(const std::filesystem::path& filename, std::string& contents) const;
 		mh::task<std::error_condition> LoadFileInternalAsync(std::filesystem::path filename, std::shared_ptr<const IHTTPClient> client);
 	};
 
@@ -168,7 +176,7 @@ namespace tf2_bot_detector
 			const T* defaultMutableList = GetDefaultMutableList();
 			const T* localList = GetLocalList();
 			if (localList)
-				localList->SaveFile(mh::format("cfg/{}.json", GetBaseFileName()));
+				localList->SaveFileDeferred(mh::format("cfg/{}.json", GetBaseFileName()));
 
 			if (defaultMutableList && defaultMutableList != localList)
 			{
@@ -177,7 +185,7 @@ namespace tf2_bot_detector
 				if (!IsOfficial())
 					throw std::runtime_error(mh::format("Attempted to save non-official data to {}", filename));
 
-				defaultMutableList->SaveFile(filename);
+				defaultMutableList->SaveFileDeferred(filename);
 			}
 		}
 
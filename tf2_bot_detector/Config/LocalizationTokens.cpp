@@ -0,0 +1,464 @@
+#include "LocalizationTokens.h"
+#include "Util/JSONUtils.h"
+#include "Util/TextUtils.h"
+#include "Filesystem.h"
+#include "Log.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	template<typename CharT>
+	class LocalizationTokenScanner final
+	{
+	public:
+		using string_view_type = std::basic_string_view<CharT>;
+
+		explicit LocalizationTokenScanner(string_view_type data) : m_Data(data) {}
+
+		enum class TokenType
+		{
+			End,
+			String,
+			OpenBrace,
+			CloseBrace,
+			Conditional,
+		};
+
+		struct Token
+		{
+			TokenType m_Type = TokenType::End;
+			string_view_type m_Text;
+		};
+
+		Token Next()
+		{
+			if (m_Peeked)
+				return *std::exchange(m_Peeked, std::nullopt);
+
+			SkipWhitespaceAndComments();
+			if (m_Pos >= m_Data.size())
+				return {};
+
+			const CharT c = m_Data[m_Pos];
+			if (c == '{' || c == '}')
+			{
+				m_Pos++;
+				return { c == '{' ? TokenType::OpenBrace : TokenType::CloseBrace };
+			}
+			else if (c == '"')
+			{
+				const size_t start = ++m_Pos;
+				while (m_Pos < m_Data.size() && m_Data[m_Pos] != '"')
+				{
+					if (m_Data[m_Pos] == '\\')
+						m_Pos++;
+
+					m_Pos++;
+				}
+
+				const auto text = m_Data.substr(start, std::min(m_Pos, m_Data.size()) - start);
+				m_Pos++; // closing quote
+				return { TokenType::String, text };
+			}
+			else if (c == '[')
+			{
+				const size_t start = ++m_Pos;
+				while (m_Pos < m_Data.size() && m_Data[m_Pos] != ']')
+					m_Pos++;
+
+				const auto text = m_Data.substr(start, std::min(m_Pos, m_Data.size()) - start);
+				m_Pos++; // closing bracket
+				return { TokenType::Conditional, text };
+			}
+			else
+			{
+				const size_t start = m_Pos;
+				while (m_Pos < m_Data.size() && !IsSpace(m_Data[m_Pos]) &&
+					m_Data[m_Pos] != '{' && m_Data[m_Pos] != '}' && m_Data[m_Pos] != '"')
+				{
+					m_Pos++;
+				}
+
+				return { TokenType::String, m_Data.substr(start, m_Pos - start) };
+			}
+		}
+
+		Token Peek()
+		{
+			if (!m_Peeked)
+				m_Peeked = Next();
+
+			return *m_Peeked;
+		}
+
+	private:
+		static constexpr bool IsSpace(CharT c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == 0xFEFF; }
+
+		void SkipWhitespaceAndComments()
+		{
+			while (m_Pos < m_Data.size())
+			{
+				if (IsSpace(m_Data[m_Pos]))
+				{
+					m_Pos++;
+				}
+				else if (m_Data[m_Pos] == '/' && (m_Pos + 1) < m_Data.size() && m_Data[m_Pos + 1] == '/')
+				{
+					while (m_Pos < m_Data.size() && m_Data[m_Pos] != '\n')
+						m_Pos++;
+				}
+				else
+				{
+					break;
+				}
+			}
+		}
+
+		string_view_type m_Data;
+		size_t m_Pos = 0;
+		std::optional<Token> m_Peeked;
+	};
+
+	template<typename CharT>
+	bool StartsWithASCII(const std::basic_string_view<CharT>& str, const std::string_view& prefix)
+	{
+		if (str.size() < prefix.size())
+			return false;
+
+		for (size_t i = 0; i < prefix.size(); i++)
+		{
+			if (str[i] != CharT(prefix[i]))
+				return false;
+		}
+
+		return true;
+	}
+
+	template<typename CharT>
+	bool EqualsASCIIIgnoreCase(const std::basic_string_view<CharT>& str, const std::string_view& other)
+	{
+		if (str.size() != other.size())
+			return false;
+
+		for (size_t i = 0; i < other.size(); i++)
+		{
+			CharT c = str[i];
+			if (c >= 'A' && c <= 'Z')
+				c = CharT(c - 'A' + 'a');
+
+			char o = other[i];
+			if (o >= 'A' && o <= 'Z')
+				o = char(o - 'A' + 'a');
+
+			if (c != CharT(o))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Same platform conditionals the vdf parser understands, eg [$WIN32] or [!$X360]
+	template<typename CharT>
+	bool IsConditionalSatisfied(const std::basic_string_view<CharT>& condition)
+	{
+		bool negate = false;
+		auto name = condition;
+		if (!name.empty() && name.front() == '!')
+		{
+			negate = true;
+			name.remove_prefix(1);
+		}
+
+		bool result = false;
+#ifdef _WIN32
+		result = EqualsASCIIIgnoreCase(name, "$WIN32"sv) || EqualsASCIIIgnoreCase(name, "$WINDOWS"sv);
+#elif defined(__APPLE__)
+		result = EqualsASCIIIgnoreCase(name, "$OSX"sv) || EqualsASCIIIgnoreCase(name, "$POSIX"sv);
+#elif defined(__linux__)
+		result = EqualsASCIIIgnoreCase(name, "$LINUX"sv) || EqualsASCIIIgnoreCase(name, "$POSIX"sv);
+#endif
+
+		return result != negate;
+	}
+
+	std::string ToNarrow(const std::string_view& str) { return std::string(str); }
+	std::string ToNarrow(const std::u16string_view& str) { return ToMB(str); }
+
+	// The vdf parser only unescapes quotes and backslashes, everything else is left as-is
+	void StripEscapes(std::string& str)
+	{
+		if (str.find('\\') == str.npos)
+			return;
+
+		size_t out = 0;
+		for (size_t i = 0; i < str.size(); i++)
+		{
+			if (str[i] == '\\' && (i + 1) < str.size() && (str[i + 1] == '"' || str[i + 1] == '\\'))
+				i++;
+
+			str[out++] = str[i];
+		}
+
+		str.resize(out);
+	}
+
+	template<typename CharT>
+	LocalizationTokens ScanTokens(const std::basic_string_view<CharT>& fileData, const std::string_view& keyPrefix)
+	{
+		using Scanner = LocalizationTokenScanner<CharT>;
+		using TokenType = typename Scanner::TokenType;
+
+		LocalizationTokens retVal;
+		Scanner scanner(fileData);
+
+		size_t depth = 0;
+		size_t tokensDepth = 0; // Depth of the contents of the "Tokens" block, 0 if we're not in it
+
+		while (true)
+		{
+			const auto token = scanner.Next();
+			if (token.m_Type == TokenType::End)
+				break;
+
+			if (token.m_Type == TokenType::CloseBrace)
+			{
+				if (depth > 0)
+					depth--;
+				if (depth < tokensDepth)
+					tokensDepth = 0;
+
+				continue;
+			}
+			else if (token.m_Type != TokenType::String)
+			{
+				// Stray brace or conditional, nothing useful to do with it
+				if (token.m_Type == TokenType::OpenBrace)
+					depth++;
+
+				continue;
+			}
+
+			if (StartsWithASCII(token.m_Text, "#base"sv) || StartsWithASCII(token.m_Text, "#include"sv))
+			{
+				scanner.Next(); // included file name, we don't follow these
+				continue;
+			}
+
+			const auto value = scanner.Next();
+			if (value.m_Type == TokenType::OpenBrace)
+			{
+				depth++;
+				if (tokensDepth == 0 && depth == 2 && EqualsASCIIIgnoreCase(token.m_Text, "Tokens"sv))
+					tokensDepth = depth;
+
+				continue;
+			}
+			else if (value.m_Type != TokenType::String)
+			{
+				if (value.m_Type == TokenType::CloseBrace)
+				{
+					if (depth > 0)
+						depth--;
+					if (depth < tokensDepth)
+						tokensDepth = 0;
+				}
+
+				continue;
+			}
+
+			bool conditionSatisfied = true;
+			if (scanner.Peek().m_Type == TokenType::Conditional)
+				conditionSatisfied = IsConditionalSatisfied(scanner.Next().m_Text);
+
+			if (!conditionSatisfied || tokensDepth == 0 || depth != tokensDepth || !StartsWithASCII(token.m_Text, keyPrefix))
+				continue;
+
+			auto& entry = retVal.emplace_back(ToNarrow(token.m_Text), ToNarrow(value.m_Text));
+			StripEscapes(entry.first);
+			StripEscapes(entry.second);
+		}
+
+		return retVal;
+	}
+
+	class LocalizationTokenCache final : public ILocalizationTokenCache
+	{
+	public:
+		LocalizationTokenCache(std::filesystem::path cacheFile, std::string keyPrefix);
+
+		LocalizationTokens GetTokens(const std::filesystem::path& path) override;
+		void Save() override;
+
+	private:
+		static constexpr int CACHE_FILE_VERSION = 1;
+
+		struct Entry
+		{
+			uintmax_t m_Size = 0;
+			int64_t m_LastWriteTime = 0;
+			LocalizationTokens m_Tokens;
+		};
+
+		void Load();
+
+		std::filesystem::path m_CacheFile;
+		std::string m_KeyPrefix;
+
+		std::mutex m_Mutex;
+		std::unordered_map<std::string, Entry> m_Entries;
+		bool m_IsDirty = false;
+	};
+
+	LocalizationTokenCache::LocalizationTokenCache(std::filesystem::path cacheFile, std::string keyPrefix) :
+		m_CacheFile(std::move(cacheFile)), m_KeyPrefix(std::move(keyPrefix))
+	{
+		Load();
+	}
+
+	void LocalizationTokenCache::Load()
+	{
+		if (!std::filesystem::exists(m_CacheFile))
+			return;
+
+		try
+		{
+			const auto json = nlohmann::json::parse(IFilesystem::Get().ReadFile(m_CacheFile));
+
+			// Different prefix or format means none of the cached results apply
+			if (json.at("file_version").get<int>() != CACHE_FILE_VERSION || json.at("key_prefix").get<std::string>() != m_KeyPrefix)
+				return;
+
+			for (const auto& file : json.at("files"))
+			{
+				Entry entry;
+				entry.m_Size = file.at("size");
+				entry.m_LastWriteTime = file.at("last_write_time");
+
+				for (const auto& token : file.at("tokens"))
+					entry.m_Tokens.emplace_back(token.at(0).get<std::string>(), token.at(1).get<std::string>());
+
+				m_Entries.emplace(file.at("path").get<std::string>(), std::move(entry));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to load localization token cache from {}, rebuilding...", m_CacheFile);
+			m_Entries.clear();
+		}
+	}
+
+	LocalizationTokens LocalizationTokenCache::GetTokens(const std::filesystem::path& path)
+	{
+		const auto size = std::filesystem::file_size(path);
+		const auto lastWriteTime = std::filesystem::last_write_time(path).time_since_epoch().count();
+		const auto key = path.string();
+
+		{
+			std::lock_guard lock(m_Mutex);
+			if (auto found = m_Entries.find(key); found != m_Entries.end() &&
+				found->second.m_Size == size && found->second.m_LastWriteTime == lastWriteTime)
+			{
+				return found->second.m_Tokens;
+			}
+		}
+
+		auto tokens = ScanLocalizationFile(path, m_KeyPrefix);
+
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Entries[key] = Entry{ size, lastWriteTime, tokens };
+			m_IsDirty = true;
+		}
+
+		return tokens;
+	}
+
+	void LocalizationTokenCache::Save()
+	{
+		std::lock_guard lock(m_Mutex);
+		if (!m_IsDirty)
+			return;
+
+		nlohmann::json json =
+		{
+			{ "file_version", CACHE_FILE_VERSION },
+			{ "key_prefix", m_KeyPrefix },
+		};
+
+		auto& files = json["files"] = nlohmann::json::array();
+		for (const auto& [path, entry] : m_Entries)
+		{
+			nlohmann::json tokens = nlohmann::json::array();
+			for (const auto& [key, value] : entry.m_Tokens)
+				tokens.push_back({ key, value });
+
+			files.push_back(
+				{
+					{ "path", path },
+					{ "size", entry.m_Size },
+					{ "last_write_time", entry.m_LastWriteTime },
+					{ "tokens", std::move(tokens) },
+				});
+		}
+
+		try
+		{
+			IFilesystem::Get().WriteFile(m_CacheFile, json.dump(), PathUsage::WriteLocal);
+			m_IsDirty = false;
+		}
+		catch (const std::exception& e)
+		{
+			LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to write localization token cache to {}", m_CacheFile);
+		}
+	}
+}
+
+LocalizationTokens tf2_bot_detector::ScanLocalizationTokens(const std::string_view& fileData, const std::string_view& keyPrefix)
+{
+	return ScanTokens(fileData, keyPrefix);
+}
+
+LocalizationTokens tf2_bot_detector::ScanLocalizationTokens(const std::u16string_view& fileData, const std::string_view& keyPrefix)
+{
+	return ScanTokens(fileData, keyPrefix);
+}
+
+LocalizationTokens tf2_bot_detector::ScanLocalizationFile(const std::filesystem::path& path, const std::string_view& keyPrefix)
+{
+	const std::string data = IFilesystem::Get().ReadFile(path);
+
+	const bool hasUTF16BOM = data.size() >= 2 && data[0] == '\xFF' && data[1] == '\xFE';
+
+	// Most of TF2's localization files are UTF-16LE with a BOM. Treat files without
+	// one as UTF-16 too if they look like it (ascii chars with a zero high byte).
+	if (hasUTF16BOM || (data.size() >= 2 && data[0] != '\0' && data[1] == '\0'))
+	{
+		const size_t offset = hasUTF16BOM ? 2 : 0;
+
+		std::u16string wide((data.size() - offset) / sizeof(char16_t), u'\0');
+		std::memcpy(wide.data(), data.data() + offset, wide.size() * sizeof(char16_t));
+
+		return ScanLocalizationTokens(std::u16string_view(wide), keyPrefix);
+	}
+
+	std::string_view narrow(data);
+	if (narrow.starts_with("\xEF\xBB\xBF"sv))
+		narrow.remove_prefix(3);
+
+	return ScanLocalizationTokens(narrow, keyPrefix);
+}
+
+std::unique_ptr<ILocalizationTokenCache> ILocalizationTokenCache::Create(std::filesystem::path cacheFile, std::string keyPrefix)
+{
+	return std::make_unique<LocalizationTokenCache>(std::move(cacheFile), std::move(keyPrefix));
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	using LocalizationTokens = std::vector<std::pair<std::string, std::string>>;
+
+	// Pulls "key" "value" pairs out of the "Tokens" block of a localization file without
+	// building a full vdf tree. Only keys starting with keyPrefix are returned, in file
+	// order (so later duplicates win if applied in order). UTF-16 files are scanned
+	// in place, only the returned tokens are converted to UTF-8.
+	LocalizationTokens ScanLocalizationTokens(const std::string_view& fileData, const std::string_view& keyPrefix);
+	LocalizationTokens ScanLocalizationTokens(const std::u16string_view& fileData, const std::string_view& keyPrefix);
+
+	// Reads the file and scans it with the appropriate encoding (UTF-16LE or UTF-8, with or without BOM)
+	LocalizationTokens ScanLocalizationFile(const std::filesystem::path& path, const std::string_view& keyPrefix);
+
+	// Remembers the results of ScanLocalizationFile on disk, keyed by path, size and
+	// last write time, so unchanged files don't get read again on the next launch.
+	class ILocalizationTokenCache
+	{
+	public:
+		virtual ~ILocalizationTokenCache() = default;
+
+		static std::unique_ptr<ILocalizationTokenCache> Create(std::filesystem::path cacheFile, std::string keyPrefix);
+
+		// Thread safe
+		virtual LocalizationTokens GetTokens(const std::filesystem::path& path) = 0;
+
+		// Writes the cache back out if anything changed
+		virtual void Save() = 0;
+	};
+}
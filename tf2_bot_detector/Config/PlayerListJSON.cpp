@@ -1,6 +1,7 @@
 #include "PlayerListJSON.h"
 #include "Networking/HTTPHelpers.h"
 #include "Util/JSONUtils.h"
+#include "Util/PerfCounters.h"
 #include "ConfigHelpers.h"
 #include "Log.h"
 #include "Settings.h"
@@ -9,6 +10,8 @@
 #include <mh/text/string_insertion.hpp>
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <filesystem>
 #include <iomanip>
 #include <regex>
@@ -215,6 +218,7 @@ PlayerListData& PlayerListJSON::PlayerListFile::GetOrAddPlayer(const SteamID& id
 bool PlayerListJSON::LoadFiles()
 {
 	m_CFGGroup.LoadFiles();
+	m_ModificationCount++;
 
 	if (m_CFGGroup.IsOfficial())
 	{
@@ -294,6 +298,8 @@ auto PlayerListJSON::FindPlayerAttributes(const SteamID& id, AttributePersistenc
 
 PlayerMarks PlayerListJSON::GetPlayerAttributes(const SteamID& id) const
 {
+	TFBD_PERF_SCOPE("PlayerList GetPlayerAttributes");
+
 	if (id == m_Settings->GetLocalSteamID())
 		return {};
 
@@ -321,6 +327,8 @@ PlayerMarks PlayerListJSON::GetPlayerAttributes(const SteamID& id) const
 /// <returns></returns>
 PlayerMarks PlayerListJSON::HasPlayerAttributes(const SteamID& id, const PlayerAttributesList& attributes, AttributePersistence persistence) const
 {
+	TFBD_PERF_SCOPE("PlayerList HasPlayerAttributes");
+
 	// we should never have a playermark entry for localplayer, so return early.
 	if (id == m_Settings->GetLocalSteamID())
 		return {};
@@ -363,6 +371,7 @@ ModifyPlayerResult PlayerListJSON::ModifyPlayer(const SteamID& id,
 	{
 		OnPlayerDataChanged(defaultMutableData);
 		defaultMutableDataRef = defaultMutableData;
+		m_ModificationCount++;
 		SaveFiles();
 		return ModifyPlayerResult::FileSaved;
 	}
@@ -376,6 +385,54 @@ ModifyPlayerResult PlayerListJSON::ModifyPlayer(const SteamID& id,
 	}
 }
 
+MarkedAccountCounts PlayerListJSON::CountMarkedAccounts(const std::span<const uint32_t>& accountIDs) const
+{
+	return GetAttributeTable().Count(accountIDs);
+}
+
+uint64_t PlayerListJSON::GetAttributesVersion() const
+{
+	const bool officialLoaded = m_CFGGroup.m_OfficialList.try_get();
+	const bool thirdPartyLoaded = m_CFGGroup.m_ThirdPartyLists.try_get();
+	return (m_ModificationCount << 2) | (uint64_t(officialLoaded) << 1) | uint64_t(thirdPartyLoaded);
+}
+
+const PlayerAttributeTable& PlayerListJSON::GetAttributeTable() const
+{
+	if (const auto version = GetAttributesVersion(); m_AttributeTableVersion != version)
+	{
+		TFBD_PERF_SCOPE("PlayerList build attribute table");
+
+		const auto localID = m_Settings->GetLocalSteamID();
+		const auto AddPlayers = [&](const PlayerMap_t& players)
+		{
+			for (const auto& [id, data] : players)
+			{
+				// GetPlayerAttributes() never reports anything for us
+				if (id.Type == SteamAccountType::Individual && id != localID)
+					m_AttributeTable.Add(id.GetAccountID(), data.GetAttributes());
+			}
+		};
+
+		m_AttributeTable.clear();
+
+		if (m_CFGGroup.m_UserList)
+			AddPlayers(m_CFGGroup.m_UserList->m_Players);
+		if (auto list = m_CFGGroup.m_ThirdPartyLists.try_get())
+		{
+			for (const auto& file : *list)
+				AddPlayers(file.second);
+		}
+		if (auto list = m_CFGGroup.m_OfficialList.try_get())
+			AddPlayers(list->m_Players);
+
+		m_AttributeTable.Finalize();
+		m_AttributeTableVersion = version;
+	}
+
+	return m_AttributeTable;
+}
+
 ModifyPlayerAction PlayerListJSON::OnPlayerDataChanged(PlayerListData& data)
 {
 	ModifyPlayerAction retVal = ModifyPlayerAction::NoChanges;
@@ -452,6 +509,121 @@ PlayerAttributesList::PlayerAttributesList(PlayerAttribute attribute)
 	SetAttribute(attribute);
 }
 
+void PlayerAttributeTable::Add(uint32_t accountID, const PlayerAttributesList& attributes)
+{
+	if (attributes.empty())
+		return;
+
+	m_AccountIDs.push_back(accountID);
+	m_Attributes.push_back(bits_t(attributes.GetBits().to_ulong()));
+}
+
+void PlayerAttributeTable::Finalize()
+{
+	// Sort (id, attributes) pairs packed into a single integer, then merge duplicate ids
+	std::vector<uint64_t> entries(m_AccountIDs.size());
+	for (size_t i = 0; i < entries.size(); i++)
+		entries[i] = (uint64_t(m_AccountIDs[i]) << 32) | m_Attributes[i];
+
+	std::sort(entries.begin(), entries.end());
+
+	m_AccountIDs.clear();
+	m_Attributes.clear();
+	for (const uint64_t entry : entries)
+	{
+		const auto accountID = uint32_t(entry >> 32);
+		const auto attributes = bits_t(entry);
+
+		if (!m_AccountIDs.empty() && m_AccountIDs.back() == accountID)
+		{
+			m_Attributes.back() |= attributes;
+		}
+		else
+		{
+			m_AccountIDs.push_back(accountID);
+			m_Attributes.push_back(attributes);
+		}
+	}
+}
+
+void PlayerAttributeTable::clear()
+{
+	m_AccountIDs.clear();
+	m_Attributes.clear();
+}
+
+PlayerAttributesList PlayerAttributeTable::Find(uint32_t accountID) const
+{
+	const auto found = std::lower_bound(m_AccountIDs.begin(), m_AccountIDs.end(), accountID);
+	if (found == m_AccountIDs.end() || *found != accountID)
+		return {};
+
+	return PlayerAttributesList(PlayerAttributesList::bits_t(m_Attributes[found - m_AccountIDs.begin()]));
+}
+
+MarkedAccountCounts PlayerAttributeTable::Count(const std::span<const uint32_t>& accountIDs) const
+{
+	assert(std::is_sorted(accountIDs.begin(), accountIDs.end()));
+
+	// Tally how often each combination of attributes shows up, and only split those into
+	// per-attribute counts at the end. Keeps the loops below down to compares and an increment.
+	std::array<uint32_t, 1 << size_t(PlayerAttribute::COUNT)> combinationCounts{};
+
+	if (accountIDs.size() * 16 < m_AccountIDs.size())
+	{
+		// A few hundred friends against a big list: binary search for each one, never
+		// looking behind the previous match.
+		auto it = m_AccountIDs.begin();
+		for (const uint32_t accountID : accountIDs)
+		{
+			it = std::lower_bound(it, m_AccountIDs.end(), accountID);
+			if (it == m_AccountIDs.end())
+				break;
+
+			if (*it == accountID)
+				combinationCounts[m_Attributes[it - m_AccountIDs.begin()]]++;
+		}
+	}
+	else
+	{
+		// Similar sizes, just walk both
+		size_t i = 0;
+		size_t j = 0;
+		while (i < accountIDs.size() && j < m_AccountIDs.size())
+		{
+			if (accountIDs[i] < m_AccountIDs[j])
+			{
+				i++;
+			}
+			else if (m_AccountIDs[j] < accountIDs[i])
+			{
+				j++;
+			}
+			else
+			{
+				combinationCounts[m_Attributes[j]]++;
+				i++;
+				j++;
+			}
+		}
+	}
+
+	MarkedAccountCounts counts;
+	for (size_t combination = 1; combination < combinationCounts.size(); combination++)
+	{
+		const auto count = combinationCounts[combination];
+		counts.m_MarkedCount += count;
+
+		for (size_t attr = 0; attr < size_t(PlayerAttribute::COUNT); attr++)
+		{
+			if (combination & (size_t(1) << attr))
+				counts.m_AttributeCounts[attr] += count;
+		}
+	}
+
+	return counts;
+}
+
 bool PlayerAttributesList::SetAttribute(PlayerAttribute attribute, bool set)
 {
 	const auto ApplyChange = [&]
@@ -7,11 +7,14 @@
 #include <mh/coroutine/generator.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <array>
 #include <bitset>
 #include <chrono>
 #include <filesystem>
 #include <map>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace tf2_bot_detector
 {
@@ -70,6 +73,7 @@ namespace tf2_bot_detector
 		bool empty() const { return m_Bits.none(); }
 		std::size_t count() const { return m_Bits.count(); }
 		explicit operator bool() const { return m_Bits.any(); }
+		const bits_t& GetBits() const { return m_Bits; }
 
 	private:
 		bits_t m_Bits;
@@ -80,6 +84,41 @@ namespace tf2_bot_detector
 		return PlayerAttributesList({ lhs, rhs });
 	}
 
+	// How many of a set of accounts have been marked with each attribute
+	struct MarkedAccountCounts
+	{
+		std::array<uint32_t, size_t(PlayerAttribute::COUNT)> m_AttributeCounts{};
+		uint32_t m_MarkedCount = 0;  // Marked with at least one attribute
+
+		uint32_t GetCount(PlayerAttribute attribute) const { return m_AttributeCounts[size_t(attribute)]; }
+	};
+
+	// Every marked account, and the union of its attributes across all the lists it was added from.
+	// Stored as sorted flat arrays, so a whole friends list can be checked against it in a single
+	// pass rather than a handful of map lookups per friend.
+	class PlayerAttributeTable final
+	{
+	public:
+		// Accounts can be added in any order, and more than once. Call Finalize() when done.
+		void Add(uint32_t accountID, const PlayerAttributesList& attributes);
+		void Finalize();
+		void clear();
+
+		PlayerAttributesList Find(uint32_t accountID) const;
+
+		// accountIDs must be sorted, and not contain duplicates
+		MarkedAccountCounts Count(const std::span<const uint32_t>& accountIDs) const;
+
+		size_t size() const { return m_AccountIDs.size(); }
+
+	private:
+		using bits_t = uint8_t;
+		static_assert(size_t(PlayerAttribute::COUNT) <= 8 * sizeof(bits_t));
+
+		std::vector<uint32_t> m_AccountIDs;
+		std::vector<bits_t> m_Attributes;
+	};
+
 	struct PlayerListData
 	{
 		PlayerListData(const SteamID& id);
@@ -186,6 +225,14 @@ namespace tf2_bot_detector
 		ModifyPlayerResult ModifyPlayer(const SteamID& id,
 			const std::function<ModifyPlayerAction(PlayerListData& data)>& func);
 
+		// Same results as calling GetPlayerAttributes() on each (individual) account, but much
+		// cheaper for a few hundred at a time. accountIDs must be sorted.
+		MarkedAccountCounts CountMarkedAccounts(const std::span<const uint32_t>& accountIDs) const;
+
+		// Changes whenever the results of CountMarkedAccounts() might have, including when the
+		// official and third party lists finish loading in the background.
+		uint64_t GetAttributesVersion() const;
+
 		size_t GetPlayerCount() const { return m_CFGGroup.size(); }
 
 	private:
@@ -193,6 +240,11 @@ namespace tf2_bot_detector
 
 		ModifyPlayerAction OnPlayerDataChanged(PlayerListData& data);
 
+		uint64_t m_ModificationCount = 0;
+		const PlayerAttributeTable& GetAttributeTable() const;
+		mutable PlayerAttributeTable m_AttributeTable;
+		mutable std::optional<uint64_t> m_AttributeTableVersion;
+
 		using PlayerMap_t = std::map<SteamID, PlayerListData>;
 
 		struct PlayerListFile final : public SharedConfigFileBase
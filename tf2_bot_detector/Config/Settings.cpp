@@ -413,7 +413,7 @@ catch (...)
 
 bool Settings::SaveFile() const try
 {
-	return !ConfigFileBase::SaveFile("cfg/settings.json");
+	return !ConfigFileBase::SaveFileDeferred("cfg/settings.json");
 }
 catch (...)
 {
@@ -189,6 +189,7 @@ namespace tf2_bot_detector
 		~Settings();
 
 		void LoadFile();
+		// Cheap enough to call on every change, the actual write happens later on a background thread
 		bool SaveFile() const;
 
 		// Settings that are not saved in the config file because we want them to
@@ -0,0 +1,108 @@
+#include "ChatWrapperMatcher.h"
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+bool ChatWrapperMatcher::IsBuiltFor(const ChatWrappers& wrappers) const
+{
+	// Wrappers are regenerated all at once from random, unique sequences,
+	// so the first one changing is enough to tell them apart.
+	return m_BuiltFor == wrappers.m_Types[0].m_Full.m_Start.m_Narrow;
+}
+
+void ChatWrapperMatcher::Rebuild(const ChatWrappers& wrappers)
+{
+	m_Wrappers = wrappers;
+	m_BuiltFor = wrappers.m_Types[0].m_Full.m_Start.m_Narrow;
+
+	m_FirstByteCategories.fill(0);
+	for (size_t i = 0; i < m_Wrappers.m_Types.size(); i++)
+	{
+		const auto& start = m_Wrappers.m_Types[i].m_Full.m_Start.m_Narrow;
+		if (!start.empty())
+			m_FirstByteCategories[uint8_t(start[0])] |= uint8_t(1 << i);
+	}
+}
+
+auto ChatWrapperMatcher::TryMatch(const std::string_view& buffer, Match& match) const -> Result
+{
+	if (buffer.empty())
+		return Result::NoMatch;
+
+	const uint8_t candidates = m_FirstByteCategories[uint8_t(buffer[0])];
+	if (!candidates)
+		return Result::NoMatch;
+
+	for (size_t i = 0; i < m_Wrappers.m_Types.size(); i++)
+	{
+		if (!(candidates & (1 << i)))
+			continue;
+
+		const auto& type = m_Wrappers.m_Types[i];
+		const std::string_view fullStart = type.m_Full.m_Start.m_Narrow;
+		if (!buffer.starts_with(fullStart))
+			continue;
+
+		match.m_Category = ChatCategory(i);
+
+		// The delimiters always appear in this order, so walk forward once looking
+		// only for the next expected one (or an early end of message).
+		const std::string_view fullEnd = type.m_Full.m_End.m_Narrow;
+		const std::string_view delimiters[] =
+		{
+			type.m_Name.m_Start.m_Narrow,
+			type.m_Name.m_End.m_Narrow,
+			type.m_Message.m_Start.m_Narrow,
+			type.m_Message.m_End.m_Narrow,
+			fullEnd,
+		};
+		static constexpr std::string_view DELIMITER_NAMES[] =
+		{
+			"name begin"sv,
+			"name end"sv,
+			"message begin"sv,
+			"message end"sv,
+			"full end"sv,
+		};
+
+		size_t positions[std::size(delimiters)]{};
+		size_t stage = 0;
+
+		for (size_t pos = fullStart.size(); pos < buffer.size(); )
+		{
+			const auto remaining = buffer.substr(pos);
+			if (remaining.starts_with(delimiters[stage]))
+			{
+				positions[stage] = pos;
+				pos += delimiters[stage].size();
+
+				if (++stage == std::size(delimiters))
+					break;
+			}
+			else if (remaining.starts_with(fullEnd))
+			{
+				match.m_MissingDelimiter = DELIMITER_NAMES[stage];
+				match.m_Length = pos + fullEnd.size();
+				return Result::Malformed;
+			}
+			else
+			{
+				pos++;
+			}
+		}
+
+		if (stage < std::size(delimiters))
+			return Result::NeedMoreData;
+
+		const auto nameBegin = positions[0] + delimiters[0].size();
+		match.m_Name = buffer.substr(nameBegin, positions[1] - nameBegin);
+
+		const auto msgBegin = positions[2] + delimiters[2].size();
+		match.m_Message = buffer.substr(msgBegin, positions[3] - msgBegin);
+
+		match.m_Length = positions[4] + fullEnd.size();
+		return Result::Match;
+	}
+
+	return Result::NoMatch;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Config/ChatWrappers.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	// Identifies and slices chat lines wrapped by ChatWrappers without allocating.
+	// A table keyed on the first byte rejects ordinary lines with a single lookup, and
+	// the name/message delimiters are then located in one forward scan.
+	class ChatWrapperMatcher final
+	{
+	public:
+		enum class Result
+		{
+			NoMatch,       // Not a chat line
+			NeedMoreData,  // Starts like a chat line, but the end wrapper isn't in the buffer yet
+			Malformed,     // Found the end wrapper, but the name/message delimiters were missing
+			Match,
+		};
+
+		struct Match
+		{
+			ChatCategory m_Category{};
+			std::string_view m_Name;
+			std::string_view m_Message;
+
+			// Length of the whole wrapped chat message, including the full start/end wrappers
+			size_t m_Length = 0;
+
+			// For Malformed results: which delimiter we didn't find
+			std::string_view m_MissingDelimiter;
+		};
+
+		// Cheap check to see if Rebuild() needs to be called for these wrappers
+		bool IsBuiltFor(const ChatWrappers& wrappers) const;
+		void Rebuild(const ChatWrappers& wrappers);
+
+		Result TryMatch(const std::string_view& buffer, Match& match) const;
+
+	private:
+		ChatWrappers m_Wrappers;
+		std::string m_BuiltFor;
+
+		// Bitmask of the chat categories whose full start wrapper begins with the given byte
+		std::array<uint8_t, 256> m_FirstByteCategories{};
+		static_assert(size_t(ChatCategory::COUNT) <= 8);
+	};
+}
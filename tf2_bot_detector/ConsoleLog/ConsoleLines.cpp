@@ -5,6 +5,7 @@
 #include "GameData/UserMessageType.h"
 #include "UI/MainWindow.h"
 #include "UI/ImGui_TF2BotDetector.h"
+#include "Util/PerfCounters.h"
 #include "Util/RegexUtils.h"
 #include "Log.h"
 #include "WorldState.h"
@@ -16,6 +17,7 @@
 #include <mh/text/string_insertion.hpp>
 #include <ScopeGuards.h>
 
+#include <array>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -28,8 +30,79 @@ using namespace std::string_literals;
 using namespace std::string_view_literals;
 
 
+std::string_view tf2_bot_detector::to_string_view(ConsoleLineType type)
+{
+	switch (type)
+	{
+	case ConsoleLineType::Generic:                  return "Generic"sv;
+	case ConsoleLineType::Chat:                     return "Chat"sv;
+	case ConsoleLineType::Ping:                     return "Ping"sv;
+	case ConsoleLineType::LobbyStatusFailed:        return "LobbyStatusFailed"sv;
+	case ConsoleLineType::LobbyChanged:             return "LobbyChanged"sv;
+	case ConsoleLineType::DifferingLobbyReceived:   return "DifferingLobbyReceived"sv;
+	case ConsoleLineType::LobbyHeader:              return "LobbyHeader"sv;
+	case ConsoleLineType::LobbyMember:              return "LobbyMember"sv;
+	case ConsoleLineType::PartyHeader:              return "PartyHeader"sv;
+	case ConsoleLineType::PlayerStatus:             return "PlayerStatus"sv;
+	case ConsoleLineType::PlayerStatusIP:           return "PlayerStatusIP"sv;
+	case ConsoleLineType::PlayerStatusShort:        return "PlayerStatusShort"sv;
+	case ConsoleLineType::PlayerStatusCount:        return "PlayerStatusCount"sv;
+	case ConsoleLineType::PlayerStatusMapPosition:  return "PlayerStatusMapPosition"sv;
+	case ConsoleLineType::PlayerStatusHostName:     return "PlayerStatusHostName"sv;
+	case ConsoleLineType::ClientReachedServerSpawn: return "ClientReachedServerSpawn"sv;
+	case ConsoleLineType::KillNotification:         return "KillNotification"sv;
+	case ConsoleLineType::SuicideNotification:      return "SuicideNotification"sv;
+	case ConsoleLineType::CvarlistConvar:           return "CvarlistConvar"sv;
+	case ConsoleLineType::EdictUsage:               return "EdictUsage"sv;
+	case ConsoleLineType::SplitPacket:              return "SplitPacket"sv;
+	case ConsoleLineType::SVC_UserMessage:          return "SVC_UserMessage"sv;
+	case ConsoleLineType::ConfigExec:               return "ConfigExec"sv;
+	case ConsoleLineType::TeamsSwitched:            return "TeamsSwitched"sv;
+	case ConsoleLineType::Connecting:               return "Connecting"sv;
+	case ConsoleLineType::HostNewGame:              return "HostNewGame"sv;
+	case ConsoleLineType::GameQuit:                 return "GameQuit"sv;
+	case ConsoleLineType::QueueStateChange:         return "QueueStateChange"sv;
+	case ConsoleLineType::InQueue:                  return "InQueue"sv;
+	case ConsoleLineType::ServerJoin:               return "ServerJoin"sv;
+	case ConsoleLineType::ServerDroppedPlayer:      return "ServerDroppedPlayer"sv;
+	case ConsoleLineType::NetStatusConfig:          return "NetStatusConfig"sv;
+	case ConsoleLineType::NetLatency:               return "NetLatency"sv;
+	case ConsoleLineType::NetLoss:                  return "NetLoss"sv;
+	case ConsoleLineType::NetPacketsTotal:          return "NetPacketsTotal"sv;
+	case ConsoleLineType::NetPacketsPerClient:      return "NetPacketsPerClient"sv;
+	case ConsoleLineType::NetDataTotal:             return "NetDataTotal"sv;
+	case ConsoleLineType::NetDataPerClient:         return "NetDataPerClient"sv;
+	case ConsoleLineType::NetChannelOnline:         return "NetChannelOnline"sv;
+	case ConsoleLineType::NetChannelReliable:       return "NetChannelReliable"sv;
+	case ConsoleLineType::NetChannelLatencyLoss:    return "NetChannelLatencyLoss"sv;
+	case ConsoleLineType::NetChannelPackets:        return "NetChannelPackets"sv;
+	case ConsoleLineType::NetChannelChoke:          return "NetChannelChoke"sv;
+	case ConsoleLineType::NetChannelFlow:           return "NetChannelFlow"sv;
+	case ConsoleLineType::NetChannelTotal:          return "NetChannelTotal"sv;
+	case ConsoleLineType::COUNT:
+		break;
+	}
+
+	return "<UNKNOWN>"sv;
+}
+
+static Perf::CounterID GetParsePerfCounter(ConsoleLineType type)
+{
+	static const auto s_Counters = []
+	{
+		std::array<Perf::CounterID, size_t(ConsoleLineType::COUNT)> counters;
+		for (size_t i = 0; i < counters.size(); i++)
+			counters[i] = Perf::RegisterCounter(mh::format("Parse {}", to_string_view(ConsoleLineType(i))));
+
+		return counters;
+	}();
+
+	return size_t(type) < s_Counters.size() ? s_Counters[size_t(type)] : Perf::INVALID_COUNTER;
+}
+
 IConsoleLine::IConsoleLine(time_point_t timestamp) :
-	m_Timestamp(timestamp)
+	m_Timestamp(timestamp),
+	m_ID(s_NextID++)
 {
 }
 
@@ -58,6 +131,10 @@ std::shared_ptr<IConsoleLine> IConsoleLine::ParseConsoleLine(const std::string_v
 
 	s_TotalParseCount++;
 
+	// Attributed to whichever type the line turned out to be, so the cost of trying
+	// (and rejecting) all of the types in front of it shows up too
+	const auto startTime = Perf::clock_type::now();
+
 	const ConsoleLineTryParseArgs args{ text, timestamp, world };
 	for (auto& data : list)
 	{
@@ -69,9 +146,13 @@ std::shared_ptr<IConsoleLine> IConsoleLine::ParseConsoleLine(const std::string_v
 			continue;
 
 		data.m_AutoParseSuccessCount++;
+		Perf::Record(GetParsePerfCounter(parsed->GetType()), startTime, Perf::clock_type::now() - startTime);
 		return parsed;
 	}
 
+	static const auto s_UnparsedCounter = Perf::RegisterCounter("Parse <unparsed>");
+	Perf::Record(s_UnparsedCounter, startTime, Perf::clock_type::now() - startTime);
+
 	//if (auto chatLine = ChatConsoleLine::TryParse(text, timestamp))
 	//	return chatLine;
 
@@ -2,6 +2,7 @@
 #include "Config/ChatWrappers.h"
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "Log.h"
+#include "Util/PerfCounters.h"
 #include "Util/RegexUtils.h"
 #include "Config/Settings.h"
 #include "WorldState.h"
@@ -36,60 +37,150 @@ ConsoleLogParser::ConsoleLogParser(IWorldState& world, const Settings& settings,
 
 void ConsoleLogParser::Update()
 {
+	if (!m_FileWatcher)
+		m_FileWatcher = IFileWatcher::Create(m_FileName);
+
+	const auto changes = m_FileWatcher->Poll();
 	const auto now = clock_t::now();
-	if (!m_File && (now - m_LastFileLoadAttempt) > 1s)
+
+	bool snapshotUpdated = false;
+
+	bool linesProcessed = false;
+	bool consoleLinesUpdated = false;
+
+	// Rotated, replaced or deleted. Anything written to the old file before that
+	// is still ours to parse, so finish it off before moving to the new one.
+	if (m_File && (changes.m_Created || changes.m_Removed))
+		m_DrainingOldFile = true;
+
+	if (m_DrainingOldFile)
 	{
-		m_LastFileLoadAttempt = now;
+		// Same time budget as usual, a big backlog just takes a few updates
+		Parse(linesProcessed, snapshotUpdated, consoleLinesUpdated);
 
-		// Try to truncate
+		if (!m_ReadPending)
 		{
-			std::error_code ec;
-			const auto filesize = std::filesystem::file_size(m_FileName, ec);
-			if (ec)
-				LogWarning("Failed to get size of {}: {}", m_FileName, ec);
-			else if (std::filesystem::resize_file(m_FileName, 0, ec); ec)
-				Log("Unable to truncate {}, current size is {}", m_FileName, filesize);
-			else
-				Log("Truncated console log file");
+			m_DrainingOldFile = false;
+			m_File.reset();
+			m_LastFileLoadAttempt = {};  // Open the new one next update
+			Log("{} was replaced or removed, reopening", m_FileName);
+		}
+	}
+	else
+	{
+		// While the file is missing, its creation is what we're waiting for. The
+		// occasional retry covers files that exist but failed to open for other reasons.
+		bool opened = false;
+		if (!m_File && (changes.m_Created || (now - m_LastFileLoadAttempt) > 10s))
+		{
+			m_LastFileLoadAttempt = now;
+			opened = OpenFile();
 		}
 
-		std::error_code ec;
+		if (m_File)
 		{
-			FILE* temp = _wfsopen(m_FileName.c_str(), L"r", _SH_DENYNO);
-			if (!temp)
+			if (changes.m_Modified)
+				CheckTruncated();
+
+			if (opened || changes.Any() || m_ReadPending)
 			{
-				auto e = errno;
-				ec = std::error_code(e, std::generic_category());
+				Parse(linesProcessed, snapshotUpdated, consoleLinesUpdated);
+
+				// Parse progress
+				{
+					const auto pos = ftell(m_File.get());
+					std::error_code ec;
+					const auto length = std::filesystem::file_size(m_FileName, ec);
+					if (!ec && length > 0)
+						m_ParseProgress = float(double(pos) / length);
+				}
 			}
-			m_File.reset(temp);
 		}
-
-		if (!m_File)
-			DebugLog("Failed to open {}: {}", m_FileName, ec);
-		else
-			Log("Successfully opened {}", m_FileName);
 	}
 
-	bool snapshotUpdated = false;
+	TrySnapshot(snapshotUpdated);
 
-	bool linesProcessed = false;
-	bool consoleLinesUpdated = false;
-	if (m_File)
+	if (linesProcessed)
+		m_WorldState->GetConsoleLineListenerBroadcaster().OnConsoleLogChunkParsed(*m_WorldState, consoleLinesUpdated);
+}
+
+bool ConsoleLogParser::OpenFile()
+{
+	// Only the first time, to skip whatever the game logged before we started. Later
+	// opens are for a new file that has only ever been written by this game session.
+	if (!m_HasOpenedFile)
 	{
-		Parse(linesProcessed, snapshotUpdated, consoleLinesUpdated);
+		std::error_code ec;
+		const auto filesize = std::filesystem::file_size(m_FileName, ec);
+		if (ec)
+			LogWarning("Failed to get size of {}: {}", m_FileName, ec);
+		else if (std::filesystem::resize_file(m_FileName, 0, ec); ec)
+			Log("Unable to truncate {}, current size is {}", m_FileName, filesize);
+		else
+			Log("Truncated console log file");
+	}
 
-		// Parse progress
+	std::error_code ec;
+	{
+#ifdef WIN32
+		FILE* temp = _wfsopen(m_FileName.c_str(), L"r", _SH_DENYNO);
+#else
+		FILE* temp = fopen(m_FileName.c_str(), "r");
+#endif
+		if (!temp)
 		{
-			const auto pos = ftell(m_File.get());
-			const auto length = std::filesystem::file_size(m_FileName);
-			m_ParseProgress = float(double(pos) / length);
+			auto e = errno;
+			ec = std::error_code(e, std::generic_category());
 		}
+		m_File.reset(temp);
 	}
 
-	TrySnapshot(snapshotUpdated);
+	if (!m_File)
+	{
+		DebugLog("Failed to open {}: {}", m_FileName, ec);
+		return false;
+	}
 
-	if (linesProcessed)
-		m_WorldState->GetConsoleLineListenerBroadcaster().OnConsoleLogChunkParsed(*m_WorldState, consoleLinesUpdated);
+	Log("Successfully opened {}", m_FileName);
+	m_HasOpenedFile = true;
+	m_FileLineBuf.clear();
+	return true;
+}
+
+void ConsoleLogParser::CheckTruncated()
+{
+	// Ask the open handle rather than the directory entry, which can lag behind on Windows
+	FILE* file = m_File.get();
+	const auto pos = ftell(file);
+	fseek(file, 0, SEEK_END);
+	const auto size = ftell(file);
+
+	if (size < pos)
+	{
+		// Everything in there now was written after the truncation, so none of it has been read yet
+		Log("{} was truncated from {} to {} bytes, continuing from the start", m_FileName, pos, size);
+		fseek(file, 0, SEEK_SET);
+		m_FileLineBuf.clear();
+	}
+	else
+	{
+		fseek(file, pos, SEEK_SET);
+	}
+}
+
+void ConsoleLogParser::ParseText(const std::string_view& text)
+{
+	bool linesProcessed = false;
+	bool snapshotUpdated = false;
+	bool consoleLinesUpdated = false;
+
+	m_FileLineBuf.append(text);
+
+	auto parseEnd = m_FileLineBuf.cbegin();
+	ParseChunk(parseEnd, linesProcessed, snapshotUpdated, consoleLinesUpdated);
+	m_FileLineBuf.erase(m_FileLineBuf.begin(), parseEnd);
+
+	TrySnapshot(snapshotUpdated);
 }
 
 void ConsoleLogParser::CustomDeleters::operator()(FILE* f) const
@@ -99,6 +190,8 @@ void ConsoleLogParser::CustomDeleters::operator()(FILE* f) const
 
 void ConsoleLogParser::Parse(bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated)
 {
+	TFBD_PERF_SCOPE("Console log read");
+
 	char buf[4096];
 	size_t readCount;
 	using clock = std::chrono::steady_clock;
@@ -123,80 +216,62 @@ void ConsoleLogParser::Parse(bool& linesProcessed, bool& snapshotUpdated, bool&
 			break;
 
 	} while (readCount > 0);
+
+	// Ran out of time rather than data, so come back next update even if nothing changes
+	m_ReadPending = (readCount > 0);
 }
 
 bool ConsoleLogParser::ParseChatMessage(const std::string_view& lineStr, striter& parseEnd, std::shared_ptr<IConsoleLine>& parsed)
 {
-	for (int i = 0; i < (int)ChatCategory::COUNT; i++)
-	{
-		const auto category = ChatCategory(i);
+	TFBD_PERF_SCOPE("Parse chat wrappers");
 
-		auto& type = m_Settings->m_Unsaved.m_ChatMsgWrappers.value().m_Types[i];
-		if (lineStr.starts_with(type.m_Full.m_Start.m_Narrow))
-		{
-			auto searchBuf = std::string_view(m_FileLineBuf).substr(
-				&*lineStr.begin() - m_FileLineBuf.data() + type.m_Full.m_Start.m_Narrow.size());
+	const auto& wrappers = m_Settings->m_Unsaved.m_ChatMsgWrappers.value();
+	if (!m_ChatMatcher.IsBuiltFor(wrappers))
+		m_ChatMatcher.Rebuild(wrappers);
 
-			if (auto found = searchBuf.find(type.m_Full.m_End.m_Narrow); found != lineStr.npos)
-			{
-				if (found > 512)
-				{
-					LogError("Searched more than 512 characters ({}) for the end of the chat msg string, something is terribly wrong!", found);
-				}
+	// The message may continue past what the timestamp regex thought was the end of the line
+	const auto searchBuf = std::string_view(m_FileLineBuf).substr(&*lineStr.begin() - m_FileLineBuf.data());
 
-				searchBuf = searchBuf.substr(0, found);
+	ChatWrapperMatcher::Match match;
+	switch (m_ChatMatcher.TryMatch(searchBuf, match))
+	{
+	case ChatWrapperMatcher::Result::NoMatch:
+		return true;
 
-				auto nameBegin = searchBuf.find(type.m_Name.m_Start.m_Narrow);
-				auto nameEnd = searchBuf.find(type.m_Name.m_End.m_Narrow);
-				auto msgBegin = searchBuf.find(type.m_Message.m_Start.m_Narrow);
-				auto msgEnd = searchBuf.find(type.m_Message.m_End.m_Narrow);
+	case ChatWrapperMatcher::Result::NeedMoreData:
+		LogError("Failed to locate chat message wrapper end");
+		return false; // Not enough characters in m_FileLineBuf. Try again later.
 
-				if (nameBegin != searchBuf.npos && nameEnd != searchBuf.npos && msgBegin != searchBuf.npos && msgEnd != searchBuf.npos)
-				{
-					const auto name = searchBuf.substr(
-						nameBegin + type.m_Name.m_Start.m_Narrow.size(),
-						nameEnd - nameBegin - type.m_Name.m_Start.m_Narrow.size());
-
-					const auto msg = searchBuf.substr(
-						msgBegin + type.m_Message.m_Start.m_Narrow.size(),
-						msgEnd - msgBegin - type.m_Message.m_Start.m_Narrow.size());
-
-					TeamShareResult teamShareResult = TeamShareResult::Neither;
-					SteamID id;
-					bool isSelf = false;
-					if (auto player = m_WorldState->FindSteamIDForName(name))
-					{
-						teamShareResult = m_WorldState->GetTeamShareResult(*player);
-						isSelf = (player == m_Settings->GetLocalSteamID());
-						id = *player;
-					}
-
-					parsed = std::make_unique<ChatConsoleLine>(m_WorldState->GetCurrentTime(),
-						std::string(name), std::string(msg), IsDead(category), IsTeam(category), isSelf, teamShareResult, id);
-				}
-				else
-				{
-					if (nameBegin == searchBuf.npos)
-						LogError("Failed to find name begin sequence in chat message of type {}", mh::enum_fmt(category));
-					if (nameEnd == searchBuf.npos)
-						LogError("Failed to find name end sequence in chat message of type {}", mh::enum_fmt(category));
-					if (msgBegin == searchBuf.npos)
-						LogError("Failed to find message begin sequence in chat message of type {}", mh::enum_fmt(category));
-					if (msgEnd == searchBuf.npos)
-						LogError("Failed to find message end sequence in chat message of type {}", mh::enum_fmt(category));
-				}
+	case ChatWrapperMatcher::Result::Malformed:
+		LogError("Failed to find {} sequence in chat message of type {}", match.m_MissingDelimiter, mh::enum_fmt(match.m_Category));
+		break;
 
-				parseEnd += type.m_Full.m_Start.m_Narrow.size() + found + type.m_Full.m_End.m_Narrow.size();
-				return true;
-			}
-			else
-			{
-				LogError("Failed to locate chat message wrapper end");
-				return false; // Not enough characters in m_FileLineBuf. Try again later.
-			}
+	case ChatWrapperMatcher::Result::Match:
+	{
+		if (match.m_Length > 512)
+		{
+			LogError("Searched more than 512 characters ({}) for the end of the chat msg string, something is terribly wrong!", match.m_Length);
+		}
+
+		TeamShareResult teamShareResult = TeamShareResult::Neither;
+		SteamID id;
+		bool isSelf = false;
+		if (auto player = m_WorldState->FindSteamIDForName(match.m_Name))
+		{
+			teamShareResult = m_WorldState->GetTeamShareResult(*player);
+			isSelf = (player == m_Settings->GetLocalSteamID());
+			id = *player;
 		}
+
+		parsed = std::make_unique<ChatConsoleLine>(m_WorldState->GetCurrentTime(),
+			std::string(match.m_Name), std::string(match.m_Message),
+			IsDead(match.m_Category), IsTeam(match.m_Category), isSelf, teamShareResult, id);
+
+		break;
+	}
 	}
 
+	parseEnd += match.m_Length;
 	return true;
 }
 
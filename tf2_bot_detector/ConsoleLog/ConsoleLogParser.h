@@ -1,6 +1,8 @@
 #pragma once
 
+#include "ChatWrapperMatcher.h"
 #include "CompensatedTS.h"
+#include "FileWatcher.h"
 
 #include <filesystem>
 #include <memory>
@@ -20,6 +22,10 @@ namespace tf2_bot_detector
 
 		void Update();
 
+		// Parses a block of console output as if it had just been read from console.log.
+		// Used to feed the parser without a file (benchmarks).
+		void ParseText(const std::string_view& text);
+
 		float GetParseProgress() const { return m_ParseProgress; }
 
 		const CompensatedTS& GetCurrentTimestamp() const { return m_CurrentTimestamp; }
@@ -43,14 +49,21 @@ namespace tf2_bot_detector
 		void Parse(bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated);
 		void ParseChunk(striter& parseEnd, bool& linesProcessed, bool& snapshotUpdated, bool& consoleLinesUpdated);
 		bool ParseChatMessage(const std::string_view& lineStr, striter& parseEnd, std::shared_ptr<IConsoleLine>& parsed);
+		ChatWrapperMatcher m_ChatMatcher;
 
 		struct CustomDeleters
 		{
 			void operator()(FILE*) const;
 		};
+		bool OpenFile();
+		void CheckTruncated();
 		std::filesystem::path m_FileName;
 		std::unique_ptr<FILE, CustomDeleters> m_File;
+		std::unique_ptr<IFileWatcher> m_FileWatcher;
 		time_point_t m_LastFileLoadAttempt{};
+		bool m_HasOpenedFile = false;
+		bool m_ReadPending = false;  // Parse() stopped before reaching the end of the file
+		bool m_DrainingOldFile = false;  // m_File was replaced or removed, reading what's left of it
 		std::string m_FileLineBuf;
 		float m_ParseProgress = 0;
 	};
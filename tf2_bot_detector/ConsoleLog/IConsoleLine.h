@@ -2,6 +2,8 @@
 
 #include "Clock.h"
 
+#include <atomic>
+#include <cstdint>
 #include <list>
 #include <memory>
 #include <string_view>
@@ -61,8 +63,12 @@ namespace tf2_bot_detector
 		NetChannelChoke,
 		NetChannelFlow,
 		NetChannelTotal,
+
+		COUNT,
 	};
 
+	std::string_view to_string_view(ConsoleLineType type);
+
 	enum class ConsoleLineOrdering
 	{
 		Auto,
@@ -98,6 +104,9 @@ namespace tf2_bot_detector
 
 		time_point_t GetTimestamp() const { return m_Timestamp; }
 
+		// Unique for the lifetime of the process, unlike the line's address
+		uint64_t GetID() const { return m_ID; }
+
 	protected:
 		using TryParseFunc = std::shared_ptr<IConsoleLine>(*)(const ConsoleLineTryParseArgs& args);
 		struct ConsoleLineTypeData
@@ -114,6 +123,9 @@ namespace tf2_bot_detector
 
 	private:
 		time_point_t m_Timestamp;
+		uint64_t m_ID;
+
+		inline static std::atomic<uint64_t> s_NextID = 0;
 
 		static std::list<ConsoleLineTypeData>& GetTypeData();
 		inline static ConsoleLineTypeData* s_TypeData = nullptr;
@@ -4,6 +4,7 @@
 #include "DBHelpers.h"
 #include "Filesystem.h"
 #include "SteamID.h"
+#include "Util/PerfCounters.h"
 
 #include <mh/error/ensure.hpp>
 #include <mh/concurrency/thread_sentinel.hpp>
@@ -11,7 +12,9 @@
 #include <sqlite3.h>
 #include <SQLiteCpp/SQLiteCpp.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 using namespace tf2_bot_detector;
 using namespace tf2_bot_detector::DB;
@@ -21,7 +24,7 @@ namespace
 	class TempDB final : public ITempDB
 	{
 	public:
-		TempDB();
+		TempDB(std::string dbPath);
 
 		void Store(const AccountAgeInfo& info) override;
 		bool TryGet(AccountAgeInfo& info) const override;
@@ -33,10 +36,17 @@ namespace
 		void Store(const AccountInventorySizeInfo& info) override;
 		bool TryGet(AccountInventorySizeInfo& info) const override;
 
+		void Store(const AccountFriendsListInfo& info) override;
+		bool TryGet(AccountFriendsListInfo& info) const override;
+		size_t GetCachedFriendAccountIDs(const std::span<const uint32_t>& accountIDs,
+			std::vector<uint32_t>& friendAccountIDs) const override;
+
 	private:
 		static constexpr size_t DB_VERSION = 4;
 		void Connect();
+		void PurgeExpiredFriendsLists();
 
+		std::string m_DBPath;
 		std::optional<SQLite::Database> m_Connection;
 	};
 
@@ -86,7 +96,28 @@ namespace
 
 	} static const s_TableInventorySize;
 
-	TempDB::TempDB() try
+	struct TABLE_FRIENDS_LISTS final : BASETABLE_EXPIRABLE
+	{
+		TABLE_FRIENDS_LISTS() : BASETABLE_EXPIRABLE("TABLE_FRIENDS_LISTS") {}
+
+		// Sorted array of 32-bit account IDs
+		const ColumnDefinition COL_FRIENDS = Column("Friends", ColumnType::Blob, ColumnFlags::NotNull);
+
+	} static const s_TableFriendsLists;
+
+	static void ReadFriendAccountIDs(const SQLite::Column& column, std::vector<uint32_t>& friendAccountIDs)
+	{
+		const auto count = size_t(column.getBytes()) / sizeof(uint32_t);
+		if (count == 0)
+			return;
+
+		const auto prevSize = friendAccountIDs.size();
+		friendAccountIDs.resize(prevSize + count);
+		std::memcpy(friendAccountIDs.data() + prevSize, column.getBlob(), count * sizeof(uint32_t));
+	}
+
+	TempDB::TempDB(std::string dbPath) try :
+		m_DBPath(std::move(dbPath))
 	{
 		Connect();
 
@@ -94,9 +125,9 @@ namespace
 		if (const auto currentUserVersion = m_Connection->execAndGet("PRAGMA user_version").getInt();
 			currentUserVersion != DB_VERSION)
 		{
-			LogWarning("Current {} version = {}. Deleting and recreating...", CreateDBPath(), currentUserVersion);
+			LogWarning("Current {} version = {}. Deleting and recreating...", m_DBPath, currentUserVersion);
 			m_Connection.reset();
-			std::filesystem::remove(CreateDBPath());
+			std::filesystem::remove(m_DBPath);
 			Connect();
 			m_Connection->exec(mh::format("PRAGMA user_version = {}", DB_VERSION)); // TODO check current user_version and delete if different
 		}
@@ -106,6 +137,9 @@ namespace
 		CreateTable(m_Connection.value(), s_TableAccountAges, CreateTableFlags::IfNotExists);
 		CreateTable(m_Connection.value(), s_TableLogsTFCache, CreateTableFlags::IfNotExists);
 		CreateTable(m_Connection.value(), s_TableInventorySize, CreateTableFlags::IfNotExists);
+		CreateTable(m_Connection.value(), s_TableFriendsLists, CreateTableFlags::IfNotExists);
+
+		PurgeExpiredFriendsLists();
 	}
 	catch (...)
 	{
@@ -148,6 +182,8 @@ namespace
 {
 	void TempDB::Store(const AccountAgeInfo& info) try
 	{
+		TFBD_PERF_SCOPE("TempDB Store AccountAge");
+
 		ReplaceInto(m_Connection.value(), s_TableAccountAges.GetTableName(),
 			{
 				{ s_TableAccountAges.COL_ACCOUNT_ID, info.m_SteamID },
@@ -162,6 +198,8 @@ namespace
 
 	bool TempDB::TryGet(AccountAgeInfo& info) const try
 	{
+		TFBD_PERF_SCOPE("TempDB TryGet AccountAge");
+
 		auto& db = const_cast<SQLite::Database&>(m_Connection.value());
 
 		auto query = SelectStatementBuilder(s_TableAccountAges.GetTableName())
@@ -184,6 +222,8 @@ namespace
 
 	void TempDB::GetNearestAccountAgeInfos(SteamID id, std::optional<AccountAgeInfo>& lower, std::optional<AccountAgeInfo>& upper) const
 	{
+		TFBD_PERF_SCOPE("TempDB GetNearestAccountAgeInfos");
+
 		auto queryStr = mh::format(R"SQL(
 SELECT max({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_AccountAges} WHERE {col_AccountID} <= $steamID
 UNION ALL
@@ -226,11 +266,13 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 	void TempDB::Connect()
 	{
 		assert(!m_Connection.has_value());
-		m_Connection.emplace(CreateDBPath(), SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE | SQLite::OPEN_FULLMUTEX);
+		m_Connection.emplace(m_DBPath, SQLite::OPEN_READWRITE | SQLite::OPEN_CREATE | SQLite::OPEN_FULLMUTEX);
 	}
 
 	void TempDB::Store(const LogsTFCacheInfo& info) try
 	{
+		TFBD_PERF_SCOPE("TempDB Store LogsTFCache");
+
 		ReplaceInto(m_Connection.value(), s_TableLogsTFCache.GetTableName(),
 			{
 				{ s_TableLogsTFCache.COL_ACCOUNT_ID, info.GetSteamID() },
@@ -246,6 +288,8 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 
 	bool TempDB::TryGet(LogsTFCacheInfo& info) const
 	{
+		TFBD_PERF_SCOPE("TempDB TryGet LogsTFCache");
+
 		auto query = SelectStatementBuilder(s_TableLogsTFCache.GetTableName())
 			.Where(s_TableLogsTFCache.COL_ACCOUNT_ID == info.m_ID)
 			.Run(m_Connection.value());
@@ -262,6 +306,8 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 
 	void TempDB::Store(const AccountInventorySizeInfo& info) try
 	{
+		TFBD_PERF_SCOPE("TempDB Store InventorySize");
+
 		ReplaceInto(m_Connection.value(), s_TableInventorySize.GetTableName(),
 			{
 				{ s_TableInventorySize.COL_ACCOUNT_ID, info.GetSteamID() },
@@ -278,6 +324,8 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 
 	bool TempDB::TryGet(AccountInventorySizeInfo& info) const
 	{
+		TFBD_PERF_SCOPE("TempDB TryGet InventorySize");
+
 		auto query = SelectStatementBuilder(s_TableInventorySize.GetTableName())
 			.Where(s_TableInventorySize.COL_ACCOUNT_ID == info.GetSteamID())
 			.Run(m_Connection.value());
@@ -292,9 +340,122 @@ SELECT min({col_AccountID}) AS {col_AccountID}, {col_CreationTime} FROM {tbl_Acc
 
 		return false;
 	}
+
+	void TempDB::Store(const AccountFriendsListInfo& info) try
+	{
+		TFBD_PERF_SCOPE("TempDB Store FriendsList");
+
+		std::vector<uint32_t> friendAccountIDs;
+		friendAccountIDs.reserve(info.m_Friends.size());
+		for (const SteamID& id : info.m_Friends)
+		{
+			if (id.Type == SteamAccountType::Individual)
+				friendAccountIDs.push_back(id.GetAccountID());
+		}
+
+		std::sort(friendAccountIDs.begin(), friendAccountIDs.end());
+
+		// sqlite binds a null pointer as NULL rather than as an empty blob
+		static constexpr uint32_t EMPTY_BLOB = 0;
+		const BlobData blob{ friendAccountIDs.empty() ? &EMPTY_BLOB : friendAccountIDs.data(), friendAccountIDs.size() * sizeof(uint32_t) };
+
+		ReplaceInto(m_Connection.value(), s_TableFriendsLists.GetTableName(),
+			{
+				{ s_TableFriendsLists.COL_ACCOUNT_ID, info.GetSteamID() },
+				{ s_TableFriendsLists.COL_LAST_UPDATE_TIME, info.m_LastCacheUpdateTime },
+				{ s_TableFriendsLists.COL_FRIENDS, blob },
+			});
+	}
+	catch (...)
+	{
+		LogException();
+		throw;
+	}
+
+	bool TempDB::TryGet(AccountFriendsListInfo& info) const
+	{
+		TFBD_PERF_SCOPE("TempDB TryGet FriendsList");
+
+		auto query = SelectStatementBuilder(s_TableFriendsLists.GetTableName())
+			.Where(s_TableFriendsLists.COL_ACCOUNT_ID == info.GetSteamID())
+			.Run(m_Connection.value());
+
+		if (query.executeStep())
+		{
+			info.m_LastCacheUpdateTime = query.getColumn(s_TableFriendsLists.COL_LAST_UPDATE_TIME);
+
+			std::vector<uint32_t> friendAccountIDs;
+			ReadFriendAccountIDs(query.getColumn(s_TableFriendsLists.COL_FRIENDS), friendAccountIDs);
+
+			info.m_Friends.clear();
+			info.m_Friends.reserve(friendAccountIDs.size());
+			for (uint32_t accountID : friendAccountIDs)
+				info.m_Friends.insert(SteamID(accountID, SteamAccountType::Individual));
+
+			return true;
+		}
+
+		return false;
+	}
+
+	size_t TempDB::GetCachedFriendAccountIDs(const std::span<const uint32_t>& accountIDs,
+		std::vector<uint32_t>& friendAccountIDs) const try
+	{
+		TFBD_PERF_SCOPE("TempDB GetCachedFriendAccountIDs");
+
+		const auto queryStr = mh::format("SELECT {col_Friends} FROM {tbl_FriendsLists} WHERE {col_AccountID} = $accountID AND {col_LastUpdateTime} >= $minUpdateTime",
+			mh::fmtarg("col_Friends", s_TableFriendsLists.COL_FRIENDS.m_Name),
+			mh::fmtarg("col_AccountID", s_TableFriendsLists.COL_ACCOUNT_ID.m_Name),
+			mh::fmtarg("col_LastUpdateTime", s_TableFriendsLists.COL_LAST_UPDATE_TIME.m_Name),
+			mh::fmtarg("tbl_FriendsLists", s_TableFriendsLists.GetTableName()));
+
+		// One prepared statement for the whole batch, this is called with entire friends lists
+		SQLite::Statement query(const_cast<SQLite::Database&>(m_Connection.value()), queryStr);
+
+		const auto minUpdateTime = tfbd_clock_t::now() - AccountFriendsListInfo{}.GetCacheLiveTime();
+
+		size_t foundCount = 0;
+		for (uint32_t accountID : accountIDs)
+		{
+			query.reset();
+			query.bind("$accountID", accountID);
+			query.bind("$minUpdateTime", ColumnDataSerializer<time_point_t>::Serialize(minUpdateTime));
+
+			if (query.executeStep())
+			{
+				ReadFriendAccountIDs(query.getColumn(0), friendAccountIDs);
+				foundCount++;
+			}
+		}
+
+		return foundCount;
+	}
+	catch (...)
+	{
+		LogException();
+		throw;
+	}
+
+	void TempDB::PurgeExpiredFriendsLists()
+	{
+		// These are a lot bigger than everything else in here, don't keep them around past their expiration
+		const auto minUpdateTime = tfbd_clock_t::now() - AccountFriendsListInfo{}.GetCacheLiveTime();
+
+		SQLite::Statement statement(m_Connection.value(), mh::format("DELETE FROM {} WHERE {} < ?",
+			s_TableFriendsLists.GetTableName(), s_TableFriendsLists.COL_LAST_UPDATE_TIME.m_Name));
+		statement.bind(1, ColumnDataSerializer<time_point_t>::Serialize(minUpdateTime));
+
+		if (const auto purged = statement.exec(); purged > 0)
+			DebugLog("Purged {} expired friends lists from {}", purged, m_DBPath);
+	}
 }
 
 std::unique_ptr<ITempDB> tf2_bot_detector::DB::ITempDB::Create()
 {
-	return std::make_unique<TempDB>();
+	return std::make_unique<TempDB>(CreateDBPath());
+}
+
+std::unique_ptr<ITempDB> tf2_bot_detector::DB::ITempDB::Create(const std::filesystem::path& dbPath)
+{
+	return std::make_unique<TempDB>(dbPath.string());
 }
@@ -9,7 +9,10 @@
 #include <mh/memory/stack_info.hpp>
 
 #include <cassert>
+#include <filesystem>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace tf2_bot_detector::DB
 {
@@ -79,6 +82,8 @@ namespace tf2_bot_detector::DB
 		virtual ~ITempDB() = default;
 
 		static std::unique_ptr<ITempDB> Create();
+		// Opens (or creates) a database at a specific location instead of the usual temp/db one
+		static std::unique_ptr<ITempDB> Create(const std::filesystem::path& dbPath);
 
 		virtual void Store(const AccountAgeInfo& info) = 0;
 		[[nodiscard]] virtual bool TryGet(AccountAgeInfo& info) const = 0;
@@ -90,6 +95,15 @@ namespace tf2_bot_detector::DB
 		virtual void Store(const AccountInventorySizeInfo& info) = 0;
 		[[nodiscard]] virtual bool TryGet(AccountInventorySizeInfo& info) const = 0;
 
+		virtual void Store(const AccountFriendsListInfo& info) = 0;
+		[[nodiscard]] virtual bool TryGet(AccountFriendsListInfo& info) const = 0;
+
+		// Appends the cached, unexpired friend account IDs of each of the given accounts to
+		// friendAccountIDs (unsorted, may contain duplicates). Never touches the network.
+		// Returns the number of accounts that had a cached friends list.
+		virtual size_t GetCachedFriendAccountIDs(const std::span<const uint32_t>& accountIDs,
+			std::vector<uint32_t>& friendAccountIDs) const = 0;
+
 		template<typename TInfo, typename TUpdateFunc>
 		mh::task<> GetOrUpdateAsync(TInfo& info, TUpdateFunc&& updateFunc)
 		{
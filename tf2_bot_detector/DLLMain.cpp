@@ -1,6 +1,7 @@
 #include "DLLMain.h"
 
 #include "Application.h"
+#include "FrameScheduler.h"
 #include "Tests/Tests.h"
 #include "Util/TextUtils.h"
 #include "Log.h"
@@ -108,19 +109,7 @@ TF2_BOT_DETECTOR_EXPORT int tf2_bot_detector::RunProgram(int argc, const char**
 			mainwin->OpenGLInit();
 
 			// renderer.RegisterDrawCallback([]() {});
-			renderer.RegisterDrawCallback([main_window = std::move(mainwin), &renderer, app]() {
-				// TODO: Put this in a different thread?
-				// update our main state instantly, if we are focused or we're forced by application log
-				if ((renderer.InFocus() || app->ShouldUpdate())) {
-					app->Update();
-				}
-				// update our main state, after we wait 100ms anyway (FIXME/HACK: this replicates the "FIXME" behaivor in imgui_desktop).
-				// https://github.com/PazerOP/imgui_desktop/blob/2e103fd66a39725a75fe93267bff1c701f246c34/imgui_desktop/src/Application.cpp#L52-L53
-				else {
-					Sleep(100);
-					app->Update();
-				}
-
+			renderer.RegisterDrawCallback([main_window = std::move(mainwin)]() {
 				// important note: while mainwindow handles only drawing related stuff,
 				// it also handles "wake from sleep", when our application log (not tf2 log!) has new stuff
 				main_window->Draw();
@@ -136,10 +125,33 @@ TF2_BOT_DETECTOR_EXPORT int tf2_bot_detector::RunProgram(int argc, const char**
 			});
 		}
 
+		// Update() runs on a fixed tick (or sooner if something wakes us), but frames
+		// are only drawn when something actually changed.
+		FrameScheduler& scheduler = GetFrameScheduler();
+		scheduler.SetWakeCallback([&renderer]() { renderer.Wake(); });
+
 		DebugLog("Entering event loop...");
 		while (!renderer.ShouldQuit()) {
-			renderer.DrawFrame();
+			const auto waitTime = std::chrono::ceil<std::chrono::milliseconds>(scheduler.GetTimeUntilNextWork());
+			if (renderer.WaitForEvents(static_cast<int>(waitTime.count())))
+				scheduler.RequestFrame(WakeReason::Input);
+
+			scheduler.SetMinFrameInterval(std::chrono::duration_cast<FrameScheduler::duration_type>(
+				std::chrono::duration<float, std::milli>(renderer.GetFramerate())));
+			scheduler.SetIdleRedrawEnabled(renderer.InFocus() || !app->IsSleepingEnabled());
+
+			if (scheduler.IsUpdateDue()) {
+				app->Update();
+				scheduler.OnUpdated();
+			}
+
+			if (scheduler.BeginFrame()) {
+				renderer.DrawFrame();
+				scheduler.EndFrame();
+			}
 		}
+
+		scheduler.SetWakeCallback(nullptr);
 #endif
 
 		// this was used for "PrintLogMsg" in imgui_desktop, i'm leaving it out because
@@ -251,10 +263,11 @@ void tf2_bot_detector::RunProgramOverlay(HMODULE module) {
 
 	// do tf2bd logic here
 	// TODO: a way to quit
+	FrameScheduler& scheduler = GetFrameScheduler();
 	while (true) {
-		if (app->ShouldUpdate()) {
-			app->Update();
-		}
+		scheduler.WaitForUpdate();
+		app->Update();
+		scheduler.OnUpdated();
 	}
 
 	/*
@@ -0,0 +1,65 @@
+#include "FileWatcher.h"
+#include "Log.h"
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// Windows only updates the size/write time in a file's directory entry lazily while
+	// another process has it open for writing, so those can't tell us when to read. This
+	// only notices the file coming and going, and otherwise reports it as (possibly)
+	// modified every time, so callers try reading on every poll.
+	class PollingFileWatcher final : public IFileWatcher
+	{
+	public:
+		explicit PollingFileWatcher(std::filesystem::path path);
+
+		FileChanges Poll() override;
+
+	private:
+		bool Exists() const;
+
+		std::filesystem::path m_Path;
+		bool m_Exists = false;
+	};
+
+	PollingFileWatcher::PollingFileWatcher(std::filesystem::path path) :
+		m_Path(std::move(path))
+	{
+		m_Exists = Exists();
+	}
+
+	bool PollingFileWatcher::Exists() const
+	{
+		std::error_code ec;
+		return std::filesystem::is_regular_file(m_Path, ec);
+	}
+
+	FileChanges PollingFileWatcher::Poll()
+	{
+		const bool exists = Exists();
+
+		FileChanges changes;
+		if (exists != m_Exists)
+		{
+			changes.m_Created = exists;
+			changes.m_Removed = !exists;
+		}
+		else if (exists)
+		{
+			changes.m_Modified = true;
+		}
+
+		m_Exists = exists;
+		return changes;
+	}
+}
+
+std::unique_ptr<IFileWatcher> IFileWatcher::Create(std::filesystem::path path)
+{
+	if (auto watcher = Platform::CreateNativeFileWatcher(path))
+		return watcher;
+
+	DebugLog("Falling back to polling for changes to {}", path);
+	return std::make_unique<PollingFileWatcher>(std::move(path));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+namespace tf2_bot_detector
+{
+	struct FileChanges
+	{
+		bool m_Modified = false;  // Written to or truncated
+		bool m_Created = false;   // Created, or another file was moved to this path
+		bool m_Removed = false;   // Deleted, or moved somewhere else
+
+		bool Any() const { return m_Modified || m_Created || m_Removed; }
+	};
+
+	// Watches a single file (which doesn't have to exist yet) for changes.
+	// Uses inotify on Linux. Elsewhere it falls back to polling, which can only tell when the
+	// file appears or disappears, so every other poll reports it as modified.
+	class IFileWatcher
+	{
+	public:
+		virtual ~IFileWatcher() = default;
+
+		static std::unique_ptr<IFileWatcher> Create(std::filesystem::path path);
+
+		// Never blocks. Returns everything that happened to the file since the last call.
+		virtual FileChanges Poll() = 0;
+	};
+
+	inline namespace Platform
+	{
+		// The OS's change notification mechanism, or nullptr if it isn't available
+		std::unique_ptr<IFileWatcher> CreateNativeFileWatcher(const std::filesystem::path& path);
+	}
+}
@@ -211,12 +211,22 @@ void Filesystem::WriteFile(std::filesystem::path path, const void* begin, const
 	if (auto folderPath = mh::copy(path).remove_filename(); std::filesystem::create_directories(folderPath))
 		DebugLog("Created one or more directories in the path {}", folderPath);
 
-	std::ofstream file;
-	file.exceptions(std::ios::badbit | std::ios::failbit);
-	file.open(path, std::ios::binary | std::ios::trunc);
+	// Write everything to a temporary file first, then swap it in, so a crash or a full
+	// disk part way through never leaves a half-written file behind.
+	auto tempPath = mh::copy(path) += ".tmp";
+	{
+		std::ofstream file;
+		file.exceptions(std::ios::badbit | std::ios::failbit);
+		file.open(tempPath, std::ios::binary | std::ios::trunc);
+
+		const auto bytes = uintptr_t(end) - uintptr_t(begin);
+		file.write(reinterpret_cast<const char*>(begin), bytes);
+
+		// The destructor would swallow errors from flushing the last of it
+		file.close();
+	}
 
-	const auto bytes = uintptr_t(end) - uintptr_t(begin);
-	file.write(reinterpret_cast<const char*>(begin), bytes);
+	std::filesystem::rename(tempPath, path);
 }
 catch (...)
 {
@@ -0,0 +1,172 @@
+#include "FrameScheduler.h"
+#include "Util/PerfCounters.h"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+std::string_view tf2_bot_detector::to_string_view(WakeReason reason)
+{
+	switch (reason)
+	{
+	case WakeReason::ConsoleLog: return "Console Log"sv;
+	case WakeReason::HTTP:       return "HTTP"sv;
+	case WakeReason::RCON:       return "RCON"sv;
+	case WakeReason::Input:      return "Input"sv;
+	case WakeReason::Timer:      return "Timer"sv;
+	case WakeReason::AppLog:     return "App Log"sv;
+	case WakeReason::World:      return "World"sv;
+	case WakeReason::Requested:  return "Requested"sv;
+	case WakeReason::Animation:  return "Animation"sv;
+
+	case WakeReason::COUNT:
+		break;
+	}
+
+	return "<UNKNOWN>"sv;
+}
+
+FrameScheduler& tf2_bot_detector::GetFrameScheduler()
+{
+	static FrameScheduler s_Scheduler;
+	return s_Scheduler;
+}
+
+void FrameScheduler::RequestFrame(WakeReason reason)
+{
+	m_Wakeups[size_t(reason)]++;
+
+	// Only wake the main loop on the clean -> dirty transition, further requests
+	// before the next update/frame would just be redundant wakeups.
+	const bool wasUpdateRequested = m_UpdateRequested.exchange(true);
+	const bool wasFrameDirty = m_FrameDirty.exchange(true);
+	if (wasUpdateRequested && wasFrameDirty)
+		return;
+
+	std::lock_guard lock(m_WakeMutex);
+	m_WakeCV.notify_all();
+	if (m_WakeCallback)
+		m_WakeCallback();
+}
+
+void FrameScheduler::SetWakeCallback(std::function<void()> callback)
+{
+	std::lock_guard lock(m_WakeMutex);
+	m_WakeCallback = std::move(callback);
+}
+
+void FrameScheduler::RequestAnimationFrames(duration_type interval)
+{
+	m_NextAnimationInterval = std::min(m_NextAnimationInterval, interval);
+}
+
+void FrameScheduler::SetMinFrameInterval(duration_type interval)
+{
+	m_MinFrameInterval = std::max<duration_type>(interval, 0s);
+}
+
+auto FrameScheduler::GetNextFrameTime() const -> clock_type::time_point
+{
+	if (m_FrameDirty || m_SettleFramesRemaining > 0)
+		return m_LastFrameStart + m_MinFrameInterval;
+	else if (m_AnimationInterval != duration_type::max())
+		return m_LastFrameStart + std::max(m_AnimationInterval, m_MinFrameInterval);
+	else if (m_IdleRedrawEnabled)
+		return m_LastFrameStart + std::max(IDLE_REDRAW_INTERVAL, m_MinFrameInterval);
+	else
+		return clock_type::time_point::max();
+}
+
+auto FrameScheduler::GetTimeUntilNextWork() const -> duration_type
+{
+	const auto now = clock_type::now();
+
+	auto next = GetNextFrameTime();
+	if (m_UpdateRequested)
+		next = now;
+	else
+		next = std::min(next, m_LastUpdate + UPDATE_INTERVAL);
+
+	return next > now ? next - now : 0s;
+}
+
+void FrameScheduler::WaitForUpdate()
+{
+	if (m_UpdateRequested)
+		return;
+
+	const auto waitTime = (m_LastUpdate + UPDATE_INTERVAL) - clock_type::now();
+	if (waitTime <= 0s)
+		return;
+
+	std::unique_lock lock(m_WakeMutex);
+	m_WakeCV.wait_for(lock, waitTime, [&] { return m_UpdateRequested.load(); });
+}
+
+bool FrameScheduler::IsUpdateDue() const
+{
+	return m_UpdateRequested || (clock_type::now() - m_LastUpdate) >= UPDATE_INTERVAL;
+}
+
+void FrameScheduler::OnUpdated()
+{
+	// Requests made by Update() itself have already been handled by it, so
+	// clearing afterwards avoids immediately running a second, redundant Update().
+	m_UpdateRequested = false;
+	m_LastUpdate = clock_type::now();
+	m_UpdatesRun++;
+}
+
+bool FrameScheduler::BeginFrame()
+{
+	const auto now = clock_type::now();
+	if (now < GetNextFrameTime())
+		return false;
+
+	if (m_FrameDirty.exchange(false))
+		m_SettleFramesRemaining = SETTLE_FRAMES;
+	else if (m_SettleFramesRemaining > 0)
+		m_SettleFramesRemaining--;
+	else if (m_AnimationInterval != duration_type::max())
+		m_Wakeups[size_t(WakeReason::Animation)]++;
+	else
+		m_Wakeups[size_t(WakeReason::Timer)]++;
+
+	m_NextAnimationInterval = duration_type::max();
+	m_LastFrameStart = m_FrameStart = now;
+	return true;
+}
+
+void FrameScheduler::EndFrame()
+{
+	m_LastFrameTime = clock_type::now() - m_FrameStart;
+	m_FramesDrawn++;
+
+	// Only keeps animating as long as something keeps asking for it
+	m_AnimationInterval = m_NextAnimationInterval;
+
+	static const auto s_FrameCounter = Perf::RegisterCounter("Frame");
+	Perf::Record(s_FrameCounter, m_FrameStart, m_LastFrameTime);
+
+	if (m_FramesDrawn == 1)
+		m_AverageFrameTime = m_LastFrameTime;
+	else
+		m_AverageFrameTime = (m_AverageFrameTime * 15 + m_LastFrameTime) / 16;
+}
+
+auto FrameScheduler::GetStats() const -> Stats
+{
+	Stats stats;
+
+	for (size_t i = 0; i < m_Wakeups.size(); i++)
+		stats.m_Wakeups[i] = m_Wakeups[i];
+
+	stats.m_FramesDrawn = m_FramesDrawn;
+	stats.m_UpdatesRun = m_UpdatesRun;
+	stats.m_LastFrameTime = m_LastFrameTime;
+	stats.m_AverageFrameTime = m_AverageFrameTime;
+
+	return stats;
+}
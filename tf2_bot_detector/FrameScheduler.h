@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string_view>
+
+namespace tf2_bot_detector
+{
+	enum class WakeReason : uint8_t
+	{
+		ConsoleLog,  // New bytes in console.log
+		HTTP,        // An HTTP request completed
+		RCON,        // An RCON command completed
+		Input,       // Mouse/keyboard/window events
+		Timer,       // Periodic redraw while idle
+		AppLog,      // A new message was added to the visible application log
+		World,       // Player or lobby data changed during Update()
+		Requested,   // The ui asked for an update (TF2BDApplication::QueueUpdate)
+		Animation,   // Something on screen is animating (RequestAnimationFrames)
+
+		COUNT,
+	};
+
+	std::string_view to_string_view(WakeReason reason);
+
+	// Decides when the main loop should run TF2BDApplication::Update() and when it
+	// should draw a frame. Nothing is drawn unless something marked the ui dirty, and
+	// never faster than the frame cap. RequestFrame() may be called from any thread.
+	class FrameScheduler final
+	{
+	public:
+		using clock_type = std::chrono::steady_clock;
+		using duration_type = clock_type::duration;
+
+		// How often Update() runs even if nobody asked for it (polls console.log, rcon futures, etc)
+		static constexpr duration_type UPDATE_INTERVAL = std::chrono::milliseconds(100);
+		// How often we redraw with nothing dirty, so relative timestamps and graphs keep moving
+		static constexpr duration_type IDLE_REDRAW_INTERVAL = std::chrono::seconds(1);
+		// ImGui needs a couple of frames after a change for hover/layout state to settle
+		static constexpr uint32_t SETTLE_FRAMES = 2;
+
+		// Marks the ui dirty, schedules an Update() and wakes the main loop.
+		void RequestFrame(WakeReason reason);
+
+		// Something drawn this frame is animating, so keep drawing at least every interval
+		// (but still no faster than the frame cap). Has to be requested again every frame.
+		// Main thread only.
+		void RequestAnimationFrames(duration_type interval);
+
+		// Called (from any thread) by RequestFrame to break the main loop out of its wait.
+		void SetWakeCallback(std::function<void()> callback);
+
+		void SetMinFrameInterval(duration_type interval);
+		void SetIdleRedrawEnabled(bool enabled) { m_IdleRedrawEnabled = enabled; }
+
+		// How long the main loop may sleep before an update or frame is due.
+		duration_type GetTimeUntilNextWork() const;
+		// Blocks until the next Update() is due, for loops that don't draw through
+		// this scheduler (overlay mode). Returns early on RequestFrame().
+		void WaitForUpdate();
+
+		bool IsUpdateDue() const;
+		void OnUpdated();
+
+		// Returns true if a frame should be drawn now. Must be paired with EndFrame().
+		bool BeginFrame();
+		void EndFrame();
+
+		struct Stats
+		{
+			std::array<uint64_t, size_t(WakeReason::COUNT)> m_Wakeups{};
+			uint64_t m_FramesDrawn = 0;
+			uint64_t m_UpdatesRun = 0;
+			duration_type m_LastFrameTime{};
+			duration_type m_AverageFrameTime{};
+		};
+		Stats GetStats() const;
+
+	private:
+		clock_type::time_point GetNextFrameTime() const;
+
+		std::array<std::atomic<uint64_t>, size_t(WakeReason::COUNT)> m_Wakeups{};
+		std::atomic_bool m_FrameDirty = true;
+		std::atomic_bool m_UpdateRequested = true;
+
+		std::mutex m_WakeMutex;
+		std::condition_variable m_WakeCV;
+		std::function<void()> m_WakeCallback;
+
+		// Only touched by the main loop
+		duration_type m_MinFrameInterval = std::chrono::microseconds(16667);
+		bool m_IdleRedrawEnabled = true;
+		duration_type m_AnimationInterval = duration_type::max(); // Requested by the last frame drawn
+		duration_type m_NextAnimationInterval = duration_type::max(); // Requested by the frame being drawn
+		uint32_t m_SettleFramesRemaining = 0;
+		clock_type::time_point m_LastUpdate{};
+		clock_type::time_point m_LastFrameStart{};
+		clock_type::time_point m_FrameStart{};
+		uint64_t m_FramesDrawn = 0;
+		uint64_t m_UpdatesRun = 0;
+		duration_type m_LastFrameTime{};
+		duration_type m_AverageFrameTime{};
+	};
+
+	FrameScheduler& GetFrameScheduler();
+}
@@ -2,15 +2,14 @@
 
 #include "Clock.h"
 #include "SteamID.h"
+#include "GameData/PlayerDataStorage.h"
 #include "GameData/TFConstants.h"
 
 #include <mh/error/expected.hpp>
 
-#include <any>
 #include <cstdint>
 #include <optional>
 #include <ostream>
-#include <typeindex>
 
 namespace tf2_bot_detector
 {
@@ -97,37 +96,30 @@ namespace tf2_bot_detector
 		// The time that this player has been in the "active" state.
 		virtual duration_t GetActiveTime() const = 0;
 
+		// Rough estimate of the memory held by this player (api responses, friends, extension data, etc)
+		virtual size_t GetApproxMemoryUsage() const = 0;
+
 		operator SteamID() const { return GetSteamID(); }
 
 		template<typename T> inline T* GetData()
 		{
-			return const_cast<T*>(std::as_const(*this).GetData<T>());
+			return m_DataStorage.Find<T>();
 		}
 		template<typename T, typename... TArgs> inline T& GetOrCreateData(TArgs&&... args)
 		{
-			auto& storage = GetOrCreateDataStorage(typeid(T));
-			if (!storage.has_value())
-				return storage.emplace<T>(std::forward<TArgs>(args)...);
-			else
-				return std::any_cast<T&>(storage);
+			return m_DataStorage.GetOrCreate<T>(std::forward<TArgs>(args)...);
 		}
 		template<typename T> inline const T* GetData() const
 		{
-			return std::any_cast<T>(FindDataStorage(typeid(T)));
+			return m_DataStorage.Find<T>();
 		}
-		template<typename T> inline bool SetData(T&& value)
+		template<typename T> inline T& SetData(T value)
 		{
-			GetOrCreateDataStorage(typeid(T)) = std::move(value);
+			return m_DataStorage.Set<T>(std::move(value));
 		}
 
-		virtual std::any& GetOrCreateDataStorage(const std::type_index& type) = 0;
-
 	protected:
-		virtual const std::any* FindDataStorage(const std::type_index& type) const = 0;
-		virtual std::any* FindDataStorage(const std::type_index& type)
-		{
-			return const_cast<std::any*>(std::as_const(*this).FindDataStorage(type));
-		}
+		PlayerDataStorage m_DataStorage;
 	};
 }
 
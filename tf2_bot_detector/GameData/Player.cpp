@@ -4,6 +4,7 @@
 #include "Log.h"
 #include "WorldEventListener.h"
 #include "GlobalDispatcher.h"
+#include "FrameScheduler.h"
 #include "Application.h"
 #include "Actions/Actions.h"
 
@@ -48,19 +49,7 @@ const WorldState& Player::GetWorld() const
 
 const LobbyMember* Player::GetLobbyMember() const
 {
-	const auto steamID = GetSteamID();
-	for (const auto& member : m_World->GetCurrentLobbyMembers())
-	{
-		if (member.m_SteamID == steamID)
-			return &member;
-	}
-	for (const auto& member : m_World->GetPendingLobbyMembers())
-	{
-		if (member.m_SteamID == steamID)
-			return &member;
-	}
-
-	return nullptr;
+	return m_World->FindLobbyMember(GetSteamID());
 }
 
 std::optional<UserID_t> Player::GetUserID() const
@@ -158,9 +147,11 @@ const mh::expected<T>& Player::GetOrFetchDataAsync(mh::expected<T>& var, TFunc&&
 						result = ErrorCode::UnknownError;
 					}
 
+					GetFrameScheduler().RequestFrame(WakeReason::HTTP);
 					co_await GetDispatcher().co_dispatch();  // switch to main thread
 
 					var = std::move(result);
+					sharedThis->m_World->BumpPlayerDataVersion();
 				}
 				catch (...)
 				{
@@ -195,19 +186,25 @@ const mh::expected<LogsTFAPI::PlayerLogsInfo>& Player::GetLogsInfo() const
 
 const mh::expected<SteamAPI::PlayerFriends>& Player::GetFriendsInfo() const
 {
-	// TODO: use tempdb?
 	return GetOrFetchDataAsync(m_FriendsInfo,
 		[&](std::shared_ptr<const Player> pThis, auto client) -> mh::task< mh::expected<SteamAPI::PlayerFriends>>
 		{
+			DB::ITempDB& cacheDB = TF2BDApplication::GetApplication().GetTempDB();
+
+			DB::AccountFriendsListInfo cacheInfo{};
+			cacheInfo.m_SteamID = pThis->GetSteamID();
+
 			const auto& settings = pThis->GetWorld().GetSettings();
 			if (!settings.IsSteamAPIAvailable())
 				co_return SteamAPI::ErrorCode::SteamAPIDisabled;
 
-			SteamAPI::PlayerFriends data;
-
-			data.m_Friends = co_await SteamAPI::GetFriendList(settings, pThis->GetSteamID(), *client);
+			// Cached friends lists also stick around for ModeratorLogic's friends-of-friends counts
+			co_await cacheDB.GetOrUpdateAsync(cacheInfo, [&settings, client](DB::AccountFriendsListInfo& info) -> mh::task<>
+				{
+					info.m_Friends = co_await SteamAPI::GetFriendList(settings, info.GetSteamID(), *client);
+				});
 
-			co_return data;
+			co_return cacheInfo;
 		});
 }
 
@@ -263,6 +260,50 @@ duration_t Player::GetActiveTime() const
 	return m_LastStatusUpdateTime - m_LastStatusActiveBegin;
 }
 
+size_t Player::GetApproxMemoryUsage() const
+{
+	// Per-element bookkeeping of node based containers (next/prev pointers, cached hash)
+	constexpr size_t NODE_OVERHEAD = 2 * sizeof(void*);
+
+	const auto GetSourceBanSize = [](const SteamHistoryAPI::PlayerSourceBan& ban)
+	{
+		return sizeof(ban) + ban.m_UserName.capacity() + ban.m_BanReason.capacity() +
+			ban.m_UnbanReason.capacity() + ban.m_Server.capacity();
+	};
+
+	size_t retVal = sizeof(*this);
+	retVal += m_Status.m_Name.capacity() + m_Status.m_Address.capacity();
+
+	if (m_PlayerSummary)
+	{
+		retVal += m_PlayerSummary->m_RealName.capacity() + m_PlayerSummary->m_Nickname.capacity() +
+			m_PlayerSummary->m_AvatarHash.capacity() + m_PlayerSummary->m_ProfileURL.capacity();
+	}
+
+	if (m_FriendsInfo)
+	{
+		const auto& friends = m_FriendsInfo->m_Friends;
+		retVal += friends.size() * (sizeof(SteamID) + NODE_OVERHEAD) + friends.bucket_count() * sizeof(void*);
+	}
+
+	if (m_PlayerSourceBans)
+	{
+		for (const auto& ban : *m_PlayerSourceBans)
+			retVal += GetSourceBanSize(ban);
+	}
+
+	if (m_PlayerSourceBanState)
+	{
+		for (const auto& [server, ban] : *m_PlayerSourceBanState)
+			retVal += server.capacity() + GetSourceBanSize(ban) + NODE_OVERHEAD;
+	}
+
+	// Inline extension data is already counted by sizeof(*this)
+	retVal += m_DataStorage.GetHeapUsage();
+
+	return retVal;
+}
+
 std::optional<time_point_t> Player::GetEstimatedAccountCreationTime() const
 {
 	if (auto& summary = GetPlayerSummary())
@@ -289,15 +330,3 @@ void Player::SetPing(uint16_t ping, time_point_t timestamp)
 	m_LastPingUpdateTime = timestamp;
 }
 
-const std::any* Player::FindDataStorage(const std::type_index& type) const
-{
-	if (auto found = m_UserData.find(type); found != m_UserData.end())
-		return &found->second;
-
-	return nullptr;
-}
-
-std::any& Player::GetOrCreateDataStorage(const std::type_index& type)
-{
-	return m_UserData[type];
-}
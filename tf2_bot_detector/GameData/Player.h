@@ -44,6 +44,7 @@ namespace tf2_bot_detector
 		mh::expected<duration_t> GetTF2Playtime() const override;
 		bool IsFriend() const override;
 		duration_t GetActiveTime() const override;
+		size_t GetApproxMemoryUsage() const override;
 
 		std::optional<time_point_t> GetEstimatedAccountCreationTime() const override;
 
@@ -67,10 +68,6 @@ namespace tf2_bot_detector
 		void SetPing(uint16_t ping, time_point_t timestamp);
 
 	protected:
-		std::map<std::type_index, std::any> m_UserData;
-		const std::any* FindDataStorage(const std::type_index& type) const override;
-		std::any& GetOrCreateDataStorage(const std::type_index& type) override;
-
 		std::shared_ptr<Player> shared_from_this() { return std::static_pointer_cast<Player>(IPlayer::shared_from_this()); }
 		std::shared_ptr<const Player> shared_from_this() const { return std::static_pointer_cast<const Player>(IPlayer::shared_from_this()); }
 
@@ -0,0 +1,53 @@
+#include "PlayerDataStorage.h"
+
+#include <mh/text/format.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+using namespace tf2_bot_detector;
+
+static std::atomic<size_t> s_AllocatedSlotCount = 0;
+
+size_t PlayerDataSlots::GetAllocatedSlotCount()
+{
+	return s_AllocatedSlotCount;
+}
+
+size_t PlayerDataSlots::AllocateSlot()
+{
+	const size_t slot = s_AllocatedSlotCount++;
+	if (slot >= MAX_SLOTS)
+	{
+		throw std::runtime_error(mh::format("Ran out of player data slots (MAX_SLOTS = {}), increase PlayerDataSlots::MAX_SLOTS",
+			MAX_SLOTS));
+	}
+
+	return slot;
+}
+
+size_t PlayerDataStorage::size() const
+{
+	size_t retVal = 0;
+	for (const auto& slot : m_Slots)
+	{
+		if (slot.m_Object)
+			retVal++;
+	}
+
+	return retVal;
+}
+
+void PlayerDataStorage::Destroy(Slot& slot)
+{
+	if (slot.m_Object)
+		m_HeapUsage -= slot.m_Destroy(slot.m_Object);
+
+	slot = {};
+}
+
+void PlayerDataStorage::clear()
+{
+	for (auto& slot : m_Slots)
+		Destroy(slot);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace tf2_bot_detector
+{
+	// Hands out a small, dense index for each type of per-player extension data
+	// (see IPlayer::GetOrCreateData). Each type gets its index the first time it is used.
+	class PlayerDataSlots final
+	{
+	public:
+		static constexpr size_t MAX_SLOTS = 8;
+
+		template<typename T>
+		static size_t GetSlot()
+		{
+			static const size_t s_Slot = AllocateSlot();
+			return s_Slot;
+		}
+
+		static size_t GetAllocatedSlotCount();
+
+	private:
+		static size_t AllocateSlot();
+	};
+
+	// Fixed size array of extension objects, indexed by PlayerDataSlots. Objects are only
+	// allocated for the slots a player actually uses, so empty slots cost two pointers each.
+	class PlayerDataStorage final
+	{
+	public:
+		PlayerDataStorage() = default;
+		PlayerDataStorage(const PlayerDataStorage&) = delete;
+		PlayerDataStorage& operator=(const PlayerDataStorage&) = delete;
+		~PlayerDataStorage() { clear(); }
+
+		template<typename T> T* Find()
+		{
+			return const_cast<T*>(std::as_const(*this).Find<T>());
+		}
+		template<typename T> const T* Find() const
+		{
+			return static_cast<const T*>(m_Slots[PlayerDataSlots::GetSlot<T>()].m_Object);
+		}
+
+		template<typename T, typename... TArgs> T& GetOrCreate(TArgs&&... args)
+		{
+			Slot& slot = m_Slots[PlayerDataSlots::GetSlot<T>()];
+			if (!slot.m_Object)
+				Construct<T>(slot, std::forward<TArgs>(args)...);
+
+			return *static_cast<T*>(slot.m_Object);
+		}
+
+		template<typename T> T& Set(T value)
+		{
+			Slot& slot = m_Slots[PlayerDataSlots::GetSlot<T>()];
+			Destroy(slot);
+			Construct<T>(slot, std::move(value));
+			return *static_cast<T*>(slot.m_Object);
+		}
+
+		// Number of slots currently holding an object
+		size_t size() const;
+		// Bytes allocated for the objects in use
+		size_t GetHeapUsage() const { return m_HeapUsage; }
+		void clear();
+
+	private:
+		struct Slot
+		{
+			void* m_Object = nullptr;
+			size_t (*m_Destroy)(void* obj) = nullptr; // Returns the size of the destroyed object
+		};
+
+		template<typename T, typename... TArgs> void Construct(Slot& slot, TArgs&&... args)
+		{
+			slot.m_Object = new T(std::forward<TArgs>(args)...);
+			slot.m_Destroy = [](void* obj) { delete static_cast<T*>(obj); return sizeof(T); };
+			m_HeapUsage += sizeof(T);
+		}
+
+		void Destroy(Slot& slot);
+
+		std::array<Slot, PlayerDataSlots::MAX_SLOTS> m_Slots{};
+		size_t m_HeapUsage = 0;
+	};
+}
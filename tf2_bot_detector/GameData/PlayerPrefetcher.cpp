@@ -0,0 +1,87 @@
+#include "PlayerPrefetcher.h"
+#include "Config/Settings.h"
+#include "GameData/IPlayer.h"
+#include "Networking/HTTPClient.h"
+#include "WorldState.h"
+
+#include <algorithm>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	struct PlayerPrefetchData
+	{
+		bool m_Queued = false;
+	};
+}
+
+PlayerPrefetcher::PlayerPrefetcher(const WorldState& world) :
+	m_World(world)
+{
+}
+
+void PlayerPrefetcher::Queue(IPlayer& player)
+{
+	auto& data = player.GetOrCreateData<PlayerPrefetchData>();
+	if (data.m_Queued)
+		return;
+
+	data.m_Queued = true;
+
+	// These are batched into a single request for a whole bunch of players anyway
+	player.GetPlayerSummary();
+	player.GetPlayerBans();
+	player.GetPlayerSourceBanState();
+
+	m_Queue.push_back(player.GetSteamID());
+}
+
+void PlayerPrefetcher::Update()
+{
+	if (m_Queue.empty())
+		return;
+
+	const auto client = m_World.GetSettings().GetHTTPClient();
+	if (!client)
+		return;
+
+	if (const auto counts = client->GetRequestCounts(); (counts.m_InProgress + counts.m_Throttled) >= MAX_REQUESTS_IN_FLIGHT)
+		return;
+
+	// Priorities can change as teams are figured out, so decide which player is next only
+	// once we can actually start on them. Otherwise first come, first served.
+	const auto next = std::min_element(m_Queue.begin(), m_Queue.end(),
+		[&](const SteamID& a, const SteamID& b) { return GetPriority(a) < GetPriority(b); });
+
+	const SteamID id = *next;
+	m_Queue.erase(next);
+
+	const IPlayer* player = m_World.FindPlayer(id);
+	if (!player)
+		return;  // Evicted while we weren't looking
+
+	// Needed for the marked friends count on the scoreboard
+	player->GetFriendsInfo();
+
+	if (!m_World.GetSettings().m_LazyLoadAPIData)
+	{
+		player->GetTF2Playtime();
+		player->GetLogsInfo();
+		player->GetInventoryInfo();
+	}
+}
+
+auto PlayerPrefetcher::GetPriority(const SteamID& id) const -> Priority
+{
+	const auto localID = m_World.GetSettings().GetLocalSteamID();
+	if (id == localID || m_World.GetFriends().contains(id))
+		return Priority::Friend;
+
+	const auto localTeam = m_World.FindLobbyMemberTeam(localID);
+	const auto team = m_World.FindLobbyMemberTeam(id);
+	if (localTeam && team && *localTeam == *team)
+		return Priority::Teammate;
+
+	return Priority::Enemy;
+}
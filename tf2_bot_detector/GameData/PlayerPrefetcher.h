@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SteamID.h"
+
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	class IPlayer;
+	class WorldState;
+
+	// Starts fetching a player's steam/logs.tf/etc data ahead of time, rather than waiting for
+	// something to ask for it. Lobby members are queued as soon as they show up in tf_lobby_debug,
+	// so their data is usually ready by the time they've finished connecting.
+	class PlayerPrefetcher final
+	{
+	public:
+		PlayerPrefetcher(const WorldState& world);
+
+		// Does nothing if the player was already queued. With lazy loading enabled, only
+		// the data the scoreboard itself needs is fetched.
+		void Queue(IPlayer& player);
+		void Update();
+
+		size_t GetQueuedCount() const { return m_Queue.size(); }
+
+	private:
+		enum class Priority
+		{
+			Enemy,       // Including anyone we can't place on a team yet
+			Teammate,
+			Friend,      // Including ourselves
+		};
+		Priority GetPriority(const SteamID& id) const;
+
+		// Don't start anything new while this many requests are already waiting on a
+		// server or on the HTTP client's own throttling. Leaves room for what the UI asks for.
+		static constexpr uint32_t MAX_REQUESTS_IN_FLIGHT = 4;
+
+		const WorldState& m_World;
+		std::vector<SteamID> m_Queue;
+	};
+}
@@ -1,6 +1,8 @@
 #include "Log.h"
 #include "Util/PathUtils.h"
 #include "Filesystem.h"
+#include "FrameScheduler.h"
+#include "Util/SecretScrubber.h"
 
 #include <imgui.h>
 #include <mh/compiler.hpp>
@@ -13,12 +15,14 @@
 #include <SDL2/SDL_messagebox.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
@@ -38,11 +42,13 @@ namespace
 	class LogManager final : public ILogManager
 	{
 	public:
+		~LogManager();
+
 		void Init() override;
 
 		void Log(std::string msg, const LogMessageColor& color, LogSeverity severity,
 			LogVisibility visibility = LogVisibility::Default, time_point_t timestamp = tfbd_clock_t::now()) override;
-		void LogToStream(std::string msg, std::ostream& output, time_point_t timestamp = tfbd_clock_t::now(), bool skipScrub = false) const;
+		void LogToStream(const std::string& msg, std::ostream& output, time_point_t timestamp) const;
 
 		const std::filesystem::path& GetFileName() const override { return m_FileName; }
 		mh::generator<const LogMessage&> GetVisibleMsgs() const override;
@@ -59,35 +65,81 @@ namespace
 		void AddSecret(std::string value, std::string replace) override;
 
 		void LogChat(const std::string_view& chatMessage) override;
+
+		size_t GetDroppedMessageCount() const override { return m_DroppedWriteCount; }
+
 	private:
-		bool m_IsInit = false;
+		std::atomic<bool> m_IsInit = false;
 		void EnsureInit(MH_SOURCE_LOCATION_AUTO(location)) const;
 
 		std::filesystem::path m_FileName;
 		std::optional<std::stringstream> m_TempLogs = std::stringstream();   // Logs before we have been initialized
 		std::optional<std::ofstream> m_File;
-		mutable std::recursive_mutex m_LogMutex;
+		mutable std::recursive_mutex m_LogMutex;            // Init and the pre-Init temp log stream
+		mutable std::recursive_mutex m_LogMessagesMutex;    // m_LogMessages, m_NextLogMessageID, m_VisibleLogMessagesStart
 		std::deque<LogMessage> m_LogMessages;
+		uint64_t m_NextLogMessageID = 0;
 		size_t m_VisibleLogMessagesStart = 0;
 
-		struct Secret
-		{
-			std::string m_Value;
-			std::string m_Replacement;
-		};
-		std::vector<Secret> m_Secrets;
+		// Log() reads the current scrubber without taking a lock. Secrets are only added a
+		// handful of times, so every version is kept alive until we're destroyed.
+		std::atomic<const SecretScrubber*> m_SecretScrubber = nullptr;
+		std::vector<std::unique_ptr<const SecretScrubber>> m_SecretScrubbers;
+		std::mutex m_SecretsMutex;
 		void ReplaceSecrets(std::string& str) const;
 
 		static constexpr size_t MAX_LOG_MESSAGES = 500;
 
-		mutable std::recursive_mutex m_ConsoleLogMutex;
 		std::ofstream m_ConsoleLogFile;
 		std::filesystem::path m_ConsoleLogFileName;
 
 		// not pasted from ConsoleLog
-		mutable std::recursive_mutex m_ChatLogMutex;
 		std::ofstream m_ChatLogFile;
 		std::filesystem::path m_ChatLogFileName;
+
+		// Once initialized, nothing touches the files on the calling thread. Writes are
+		// pushed onto a lock-free stack, and the writer thread takes the whole thing at
+		// once, puts it back in order, and writes it out in one go.
+		enum class WriteTarget
+		{
+			Main,
+			Console,
+			Chat,
+		};
+		struct PendingWrite
+		{
+			PendingWrite* m_Next = nullptr;
+			WriteTarget m_Target{};
+			bool m_Urgent = false;
+			time_point_t m_Timestamp{};
+			std::string m_Text;
+		};
+		std::atomic<PendingWrite*> m_PendingWrites = nullptr;
+		std::atomic<size_t> m_PendingWriteBytes = 0;
+		std::atomic<size_t> m_DroppedWriteCount = 0;
+		size_t m_ReportedDroppedWriteCount = 0;
+
+		void QueueWrite(WriteTarget target, std::string text, time_point_t timestamp, bool urgent = false);
+		void WriterThreadFunc();
+
+		// Writes everything that's currently queued. Returns true if anything was urgent.
+		bool WritePendingWrites();
+		void FlushFiles();
+
+		// Once the writer has stopped, anything queued afterwards is written by whoever queued it
+		void StopWriterThread();
+		std::atomic<bool> m_WriterStopped = false;
+
+		std::thread m_WriterThread;
+		std::mutex m_WriterMutex;             // Held while writing to the files
+		std::mutex m_WriterWakeMutex;
+		std::condition_variable m_WriterWakeCV;
+		bool m_WriterWakeRequested = false;
+		bool m_WriterStopRequested = false;
+
+		// Beyond this, new messages are thrown away (and counted) instead of queued
+		static constexpr size_t MAX_PENDING_WRITE_BYTES = 8 * 1024 * 1024;
+		static constexpr auto WRITER_FLUSH_INTERVAL = 250ms;
 	};
 
 	static LogManager& GetLogState()
@@ -195,20 +247,41 @@ void LogManager::Init()
 		}
 
 		m_IsInit = true;
+		m_WriterThread = std::thread(&LogManager::WriterThreadFunc, this);
 	}
 }
 
-void LogManager::LogToStream(std::string msg, std::ostream& output, time_point_t timestamp, bool skipScrub) const
+LogManager::~LogManager()
 {
-	std::lock_guard lock(m_LogMutex);
+	StopWriterThread();
+}
 
-	if (!skipScrub)
-		ReplaceSecrets(msg);
+void LogManager::StopWriterThread()
+{
+	m_WriterStopped = true;
 
+	if (m_WriterThread.joinable())
+	{
+		{
+			std::lock_guard lock(m_WriterWakeMutex);
+			m_WriterStopRequested = true;
+		}
+
+		m_WriterWakeCV.notify_one();
+		m_WriterThread.join();
+	}
+
+	// Anything queued between the writer's last pass and m_WriterStopped being seen
+	WritePendingWrites();
+	FlushFiles();
+}
+
+void LogManager::LogToStream(const std::string& msg, std::ostream& output, time_point_t timestamp) const
+{
 	tm t = ToTM(timestamp);
 	const auto WriteToStream = [&](std::ostream& str)
 	{
-		str << '[' << std::put_time(&t, "%T") << "] " << msg << std::endl;
+		str << '[' << std::put_time(&t, "%T") << "] " << msg << '\n';
 	};
 
 	WriteToStream(output);
@@ -220,45 +293,152 @@ void LogManager::LogToStream(std::string msg, std::ostream& output, time_point_t
 #endif
 }
 
-void LogManager::AddSecret(std::string value, std::string replace)
+void LogManager::QueueWrite(WriteTarget target, std::string text, time_point_t timestamp, bool urgent)
 {
-	EnsureInit();
-
-	if (value.empty())
+	if ((m_PendingWriteBytes += text.size()) > MAX_PENDING_WRITE_BYTES)
+	{
+		// The writer has fallen way behind, don't let it take all our memory
+		m_PendingWriteBytes -= text.size();
+		m_DroppedWriteCount++;
 		return;
+	}
+
+	auto write = new PendingWrite{ .m_Target = target, .m_Urgent = urgent, .m_Timestamp = timestamp, .m_Text = std::move(text) };
+
+	write->m_Next = m_PendingWrites.load(std::memory_order_relaxed);
+	while (!m_PendingWrites.compare_exchange_weak(write->m_Next, write, std::memory_order_release, std::memory_order_relaxed))
+		;
 
-	std::lock_guard lock(m_LogMutex);
-	for (auto& scrubbed : m_Secrets)
+	if (m_WriterStopped)
+	{
+		// Shutting down, nobody else is going to write this
+		WritePendingWrites();
+		FlushFiles();
+	}
+	else if (urgent)
 	{
-		if (scrubbed.m_Value == value)
 		{
-			scrubbed.m_Replacement = std::move(replace);
-			return;
+			std::lock_guard lock(m_WriterWakeMutex);
+			m_WriterWakeRequested = true;
 		}
+		m_WriterWakeCV.notify_one();
 	}
+}
+
+bool LogManager::WritePendingWrites()
+{
+	std::lock_guard lock(m_WriterMutex);
+
+	PendingWrite* writes = m_PendingWrites.exchange(nullptr, std::memory_order_acquire);
 
-	m_Secrets.push_back(Secret
+	// Stack -> queue, so things come out in the order they went in
+	PendingWrite* ordered = nullptr;
+	while (writes)
+	{
+		PendingWrite* next = writes->m_Next;
+		writes->m_Next = ordered;
+		ordered = writes;
+		writes = next;
+	}
+
+	bool anyUrgent = false;
+
+	if (const size_t dropped = m_DroppedWriteCount; dropped != m_ReportedDroppedWriteCount)
+	{
+		LogToStream(mh::format("[LogManager] Dropped {} log writes because the writer fell behind",
+			dropped - m_ReportedDroppedWriteCount), GetLogStream(), tfbd_clock_t::now());
+		m_ReportedDroppedWriteCount = dropped;
+		anyUrgent = true;
+	}
+
+	while (ordered)
+	{
+		std::unique_ptr<PendingWrite> write(ordered);
+		ordered = write->m_Next;
+		m_PendingWriteBytes -= write->m_Text.size();
+
+		switch (write->m_Target)
 		{
-			.m_Value = std::move(value),
-			.m_Replacement = std::move(replace)
-		});
+		case WriteTarget::Main:
+			LogToStream(write->m_Text, GetLogStream(), write->m_Timestamp);
+			break;
+		case WriteTarget::Console:
+			m_ConsoleLogFile << write->m_Text;
+			break;
+		case WriteTarget::Chat:
+		{
+			tm tm_timestamp = ToTM(write->m_Timestamp);
+			m_ChatLogFile << '[' << std::put_time(&tm_timestamp, "%T") << "] " << write->m_Text;
+			break;
+		}
+		}
+
+		anyUrgent |= write->m_Urgent;
+	}
+
+	return anyUrgent;
 }
 
-void LogManager::ReplaceSecrets(std::string& msg) const
+void LogManager::FlushFiles()
+{
+	std::lock_guard lock(m_WriterMutex);
+	GetLogStream().flush();
+	std::cout.flush();
+	m_ConsoleLogFile.flush();
+	m_ChatLogFile.flush();
+}
+
+void LogManager::WriterThreadFunc()
 {
-	std::lock_guard lock(m_LogMutex);
-	for (const auto& scrubbed : m_Secrets)
+	auto lastFlush = tfbd_clock_t::now();
+
+	while (true)
 	{
-		size_t index = msg.find(scrubbed.m_Value);
-		while (index != msg.npos)
+		bool stopRequested;
 		{
-			msg.erase(index, scrubbed.m_Value.size());
-			msg.insert(index, scrubbed.m_Replacement);
-			index = msg.find(scrubbed.m_Value, index + scrubbed.m_Replacement.size());
+			std::unique_lock lock(m_WriterWakeMutex);
+			m_WriterWakeCV.wait_for(lock, WRITER_FLUSH_INTERVAL,
+				[&] { return m_WriterWakeRequested || m_WriterStopRequested; });
+
+			m_WriterWakeRequested = false;
+			stopRequested = m_WriterStopRequested;
 		}
+
+		const bool anyUrgent = WritePendingWrites();
+
+		if (const auto now = tfbd_clock_t::now(); anyUrgent || stopRequested || (now - lastFlush) >= WRITER_FLUSH_INTERVAL)
+		{
+			FlushFiles();
+			lastFlush = now;
+		}
+
+		if (stopRequested)
+			break;
 	}
 }
 
+void LogManager::AddSecret(std::string value, std::string replace)
+{
+	EnsureInit();
+
+	if (value.empty())
+		return;
+
+	std::lock_guard lock(m_SecretsMutex);
+
+	const SecretScrubber* current = m_SecretScrubber.load(std::memory_order_relaxed);
+	auto& next = m_SecretScrubbers.emplace_back(std::make_unique<const SecretScrubber>(
+		(current ? *current : SecretScrubber{}).WithSecret(std::move(value), std::move(replace))));
+
+	m_SecretScrubber.store(next.get(), std::memory_order_release);
+}
+
+void LogManager::ReplaceSecrets(std::string& msg) const
+{
+	if (const SecretScrubber* scrubber = m_SecretScrubber.load(std::memory_order_acquire))
+		scrubber->Replace(msg);
+}
+
 void tf2_bot_detector::LogFatalError(const mh::source_location& location, const std::string_view& msg)
 {
 	LogError(location, msg);
@@ -346,20 +526,38 @@ void detail::log_h::LogImplBase(const LogMessageColor& color, LogSeverity severi
 void LogManager::Log(std::string msg, const LogMessageColor& color,
 	LogSeverity severity, LogVisibility visibility, time_point_t timestamp)
 {
-	std::lock_guard lock(m_LogMutex);
 	ReplaceSecrets(msg);
 
-	LogToStream(msg, GetLogStream(), timestamp, true);
+	bool queued = false;
+	if (!m_IsInit)
+	{
+		// Before Init() there's no writer thread, everything goes to m_TempLogs and stdout
+		std::lock_guard lock(m_LogMutex);
+		if (!m_IsInit)
+		{
+			LogToStream(msg, GetLogStream(), timestamp);
+			queued = true;
+		}
+	}
+
+	if (!queued)
+		QueueWrite(WriteTarget::Main, msg, timestamp, severity >= LogSeverity::Warning);
 
 	if (!(visibility == LogVisibility::Debug && !mh::is_debug))
 	{
-		m_LogMessages.push_back({ timestamp, std::move(msg), { color.r, color.g, color.b, color.a } });
-
-		if (m_IsInit && m_LogMessages.size() > MAX_LOG_MESSAGES)
 		{
-			m_LogMessages.erase(m_LogMessages.begin(),
-				std::next(m_LogMessages.begin(), m_LogMessages.size() - MAX_LOG_MESSAGES));
+			std::lock_guard lock(m_LogMessagesMutex);
+			m_LogMessages.push_back({ m_NextLogMessageID++, timestamp, std::move(msg), { color.r, color.g, color.b, color.a } });
+
+			if (m_IsInit && m_LogMessages.size() > MAX_LOG_MESSAGES)
+			{
+				m_LogMessages.erase(m_LogMessages.begin(),
+					std::next(m_LogMessages.begin(), m_LogMessages.size() - MAX_LOG_MESSAGES));
+			}
 		}
+
+		// Not under the lock, this can end up in the platform's wake callback
+		GetFrameScheduler().RequestFrame(WakeReason::AppLog);
 	}
 }
 
@@ -367,7 +565,7 @@ mh::generator<const LogMessage&> LogManager::GetVisibleMsgs() const
 {
 	EnsureInit();
 
-	std::lock_guard lock(m_LogMutex);
+	std::lock_guard lock(m_LogMessagesMutex);
 
 	size_t start = m_VisibleLogMessagesStart;
 	if (m_LogMessages.size() > MAX_LOG_MESSAGES)
@@ -381,8 +579,9 @@ void LogManager::ClearVisibleMsgs()
 {
 	EnsureInit();
 
-	std::lock_guard lock(m_LogMutex);
 	DebugLog("Clearing visible log messages...");
+
+	std::lock_guard lock(m_LogMessagesMutex);
 	m_VisibleLogMessagesStart = m_LogMessages.size();
 }
 
@@ -402,27 +601,28 @@ void LogManager::LogConsoleOutput(const std::string_view& consoleOutput)
 {
 	EnsureInit();
 
-	std::lock_guard lock(m_ConsoleLogMutex);
-	m_ConsoleLogFile << consoleOutput << std::flush;
+	QueueWrite(WriteTarget::Console, std::string(consoleOutput), tfbd_clock_t::now());
 }
 
 void LogManager::LogChat(const std::string_view & chatMessage)
 {
 	EnsureInit();
 
-	std::lock_guard lock(m_ConsoleLogMutex);
-
-	time_point_t timestamp = tfbd_clock_t::now();
-	tm tm_timestamp = ToTM(timestamp);
-	m_ChatLogFile << '[' << std::put_time(&tm_timestamp, "%T") << "] " << chatMessage << std::flush;
+	QueueWrite(WriteTarget::Chat, std::string(chatMessage), tfbd_clock_t::now());
 }
 
 void LogManager::CleanupEmptyLogs() try
 {
 	EnsureInit();
 
-	m_ConsoleLogFile.close();
-	m_ChatLogFile.close();
+	// Everything logged from here on is written synchronously, so nothing gets lost
+	// after the console and chat logs are closed
+	StopWriterThread();
+	{
+		std::lock_guard lock(m_WriterMutex);
+		m_ConsoleLogFile.close();
+		m_ChatLogFile.close();
+	}
 
 	if (std::filesystem::file_size(m_ConsoleLogFileName) < 1) {
 		std::filesystem::remove(m_ConsoleLogFileName);
@@ -448,7 +648,7 @@ void LogManager::CleanupLogFiles() try
 	}
 
 	{
-		std::lock_guard lock(m_ConsoleLogMutex);
+		std::lock_guard lock(m_WriterMutex);
 		DeleteOldFiles("logs/console", MAX_LOG_LIFETIME);
 	}
 }
@@ -6,6 +6,7 @@
 #include <mh/text/format.hpp>
 #include <mh/source_location.hpp>
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 
@@ -39,6 +40,7 @@ namespace tf2_bot_detector
 
 	struct LogMessage
 	{
+		uint64_t m_ID;    // Unique and increasing, addresses get reused once old messages are dropped
 		time_point_t m_Timestamp;
 		std::string m_Text;
 		LogMessageColor m_Color;
@@ -98,6 +100,9 @@ namespace tf2_bot_detector
 		virtual void CleanupLogFiles() = 0;
 
 		virtual void AddSecret(std::string value, std::string replace) = 0;
+
+		// Number of log writes thrown away because the background writer couldn't keep up
+		virtual size_t GetDroppedMessageCount() const = 0;
 	};
 
 #pragma push_macro("NOINLINE")
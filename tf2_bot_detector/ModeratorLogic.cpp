@@ -1,4 +1,6 @@
 #include "ModeratorLogic.h"
+#include "Application.h"
+#include "Util/PerfCounters.h"
 #include "Util/TextUtils.h"
 #include "Actions/Actions.h"
 #include "Actions/RCONActionManager.h"
@@ -7,8 +9,13 @@
 #include "Config/Settings.h"
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/IConsoleLine.h"
+#include "ConsoleLog/ConsoleLines/LobbyHeaderLine.h"
+#include "ConsoleLog/ConsoleLines/LobbyMemberLine.h"
+#include "DB/TempDB.h"
+#include "FrameScheduler.h"
 #include "GameData/UserMessageType.h"
 #include "GameData/IPlayer.h"
+#include "GlobalDispatcher.h"
 #include "Log.h"
 #include "PlayerStatus.h"
 #include "WorldEventListener.h"
@@ -17,12 +24,16 @@
 
 #include <mh/algorithm/algorithm_generic.hpp>
 #include <mh/algorithm/multi_compare.hpp>
+#include <mh/concurrency/thread_pool.hpp>
+#include <mh/coroutine/task.hpp>
 #include <mh/text/case_insensitive_string.hpp>
 #include <mh/text/fmtstr.hpp>
 #include <mh/text/string_insertion.hpp>
 
+#include <algorithm>
 #include <iomanip>
 #include <map>
+#include <memory>
 #include <regex>
 #include <unordered_set>
 #include <fstream>
@@ -43,12 +54,16 @@ namespace
 
 		struct Cheater
 		{
-			Cheater(IPlayer& player, PlayerMarks marks) : m_Player(player), m_Marks(std::move(marks)) {}
+			Cheater(IPlayer& player, PlayerMarks marks) :
+				m_Player(player.shared_from_this()), m_Marks(std::move(marks))
+			{
+			}
 
-			std::reference_wrapper<IPlayer> m_Player;
+			// Owning, since these outlive the tick they were gathered in (see ModerationState)
+			std::shared_ptr<IPlayer> m_Player;
 			PlayerMarks m_Marks;
 
-			IPlayer* operator->() const { return &m_Player.get(); }
+			IPlayer* operator->() const { return m_Player.get(); }
 		};
 
 		PlayerMarks GetPlayerAttributes(const SteamID& id) const override;
@@ -57,6 +72,7 @@ namespace
 
 		std::string GenerateCheaterWarnMessage(const std::vector<std::string>& names) const;
 
+		uint64_t GetPlayerAttributesVersion() const override { return m_PlayerAttributesVersion; }
 		bool SetPlayerAttribute(const IPlayer& id, PlayerAttribute markType, AttributePersistence persistence, bool set = true, std::string proof = "") override;
 		bool SetPlayerAttribute(const SteamID& id, std::string name, PlayerAttribute markType, AttributePersistence persistence, bool set = true, std::string proof = "") override;
 
@@ -93,6 +109,13 @@ namespace
 		{
 			bool m_FriendsProcessed = false;
 			MarkedFriends m_MarkedFriends;
+			uint64_t m_MarkedFriendsListVersion = 0;         // PlayerListJSON::GetAttributesVersion()
+
+			// Sorted account IDs. A player's friends list is only fetched once, so these are
+			// only built once: friends as soon as the list arrives, friends of friends later
+			// on m_FriendsGraphPool (see BuildFriendsOfFriendsAsync()).
+			std::optional<std::vector<uint32_t>> m_FriendAccountIDs;
+			std::optional<std::vector<uint32_t>> m_FriendsOfFriendsAccountIDs;
 
 			// If this is a known cheater, warn them ahead of time that the player is connecting, but only once
 			// (we don't know the cheater's name yet, so don't spam if they can't do anything about it yet)
@@ -116,8 +139,14 @@ namespace
 		// Steam IDs of players that we think are running the tool.
 		std::unordered_set<SteamID> m_PlayersRunningTool;
 
+		// Reads cached friends lists out of the temp db and merges them, off the main thread
+		mutable mh::thread_pool m_FriendsGraphPool{ 1 };
+		void BuildFriendsOfFriendsAsync(IPlayer& player, std::vector<uint32_t> friendAccountIDs) const;
+
 		void OnPlayerStatusUpdate(IWorldState& world, const IPlayer& player) override;
 		void OnChatMsg(IWorldState& world, IPlayer& player, const std::string_view& msg) override;
+		void OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason) override;
+		void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override;
 
 		// called on player first spawn on server.
 		void OnLocalPlayerInitialized(IWorldState& world, bool initialized);
@@ -142,6 +171,53 @@ namespace
 		time_point_t m_NextCheaterWarningTime{};            // The soonest we can warn about connected cheaters on the other team
 		time_point_t m_LastPlayerActionsUpdate{};
 
+		// Who's in the lobby and which of them are marked, sorted into the buckets
+		// ProcessPlayerActions() cares about. Only rebuilt when something relevant
+		// changes (see m_ModerationStateDirty), instead of every tick.
+		struct ModerationState
+		{
+			std::optional<LobbyMemberTeam> m_MyTeam;
+
+			uint8_t m_TotalEnemyPlayers = 0;
+			uint8_t m_ConnectedEnemyPlayers = 0;
+			uint8_t m_TotalFriendlyPlayers = 0;
+
+			// Connected players on our team. Whether they count towards the votekick
+			// quorum depends on how long they've been active, so that is checked per tick.
+			// Players are held by shared_ptr so they stay valid until the next rebuild.
+			std::vector<std::shared_ptr<const IPlayer>> m_ConnectedFriendlyPlayers;
+
+			// all cheaters in lobby: used for m_IgnoreTeamStateOnCertainMaps.
+			std::vector<Cheater> m_AllCheaters;
+			std::vector<Cheater> m_EnemyCheaters;
+			std::vector<Cheater> m_FriendlyCheaters;
+			std::vector<Cheater> m_ConnectingEnemyCheaters;
+			// the struct Cheater doesn't really have to be always a cheater (lol)
+			std::vector<Cheater> m_ConnectingMarkedPlayers;
+
+			// What each lobby member looked like when this state was built, so events
+			// that don't change anything don't force a rebuild.
+			struct MemberSnapshot
+			{
+				std::optional<LobbyMemberTeam> m_Team;
+				PlayerStatusState m_ConnectionState{};
+				bool m_HasName = false;
+			};
+			std::unordered_map<SteamID, MemberSnapshot> m_Members;
+			size_t m_LobbyMemberCount = 0;
+		} m_ModerationState;
+
+		bool m_ModerationStateDirty = true;
+		uint64_t m_PlayerAttributesVersion = 0;
+		time_point_t m_LastModerationStateRebuild{};
+
+		// Official/third party player lists can be updated in the background without
+		// any event we can see, so rebuild every so often regardless.
+		static constexpr duration_t MODERATION_STATE_MAX_AGE = std::chrono::seconds(10);
+
+		void MarkModerationStateDirty() { m_ModerationStateDirty = true; }
+		void RebuildModerationState();
+
 		void ProcessPlayerActions();
 		void HandleFriendlyCheaters(uint8_t friendlyPlayerCount, uint8_t connectedFriendlyPlayerCount,
 			const std::vector<Cheater>& friendlyCheaters);
@@ -174,7 +250,7 @@ namespace
 	static std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const ModeratorLogic::Cheater& cheater)
 	{
 		assert(cheater.m_Marks);
-		os << cheater.m_Player.get() << " (marked in ";
+		os << *cheater.m_Player << " (marked in ";
 
 		const auto markCount = cheater.m_Marks.m_Marks.size();
 		for (size_t i = 0; i < markCount; i++)
@@ -286,8 +362,25 @@ void ModeratorLogic::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& pla
 	const auto name = player.GetNameUnsafe();
 	const auto steamID = player.GetSteamID();
 
+	if (!m_ModerationStateDirty)
+	{
+		if (auto found = m_ModerationState.m_Members.find(steamID); found != m_ModerationState.m_Members.end())
+		{
+			if (found->second.m_ConnectionState != player.GetConnectionState() ||
+				found->second.m_HasName != !name.empty())
+			{
+				MarkModerationStateDirty();
+			}
+		}
+		else if (world.FindLobbyMemberTeam(steamID))
+		{
+			MarkModerationStateDirty();
+		}
+	}
+
 	if (m_Settings->m_AutoMark)
 	{
+		TFBD_PERF_SCOPE("Rules (player)");
 		for (const ModerationRule& rule : m_Rules.GetRules())
 		{
 			if (!rule.Match(player))
@@ -298,6 +391,43 @@ void ModeratorLogic::OnPlayerStatusUpdate(IWorldState& world, const IPlayer& pla
 	}
 }
 
+void ModeratorLogic::OnPlayerDroppedFromServer(IWorldState& world, IPlayer& player, const std::string_view& reason)
+{
+	if (m_ModerationState.m_Members.contains(player.GetSteamID()))
+		MarkModerationStateDirty();
+}
+
+void ModeratorLogic::OnConsoleLineParsed(IWorldState& world, IConsoleLine& line)
+{
+	if (m_ModerationStateDirty)
+		return;
+
+	switch (line.GetType())
+	{
+	case ConsoleLineType::LobbyHeader:
+	{
+		auto& headerLine = static_cast<const LobbyHeaderLine&>(line);
+		if (size_t(headerLine.GetMemberCount() + headerLine.GetPendingCount()) != m_ModerationState.m_LobbyMemberCount)
+			MarkModerationStateDirty();
+
+		break;
+	}
+	case ConsoleLineType::LobbyMember:
+	{
+		const auto& member = static_cast<const LobbyMemberLine&>(line).GetLobbyMember();
+		auto found = m_ModerationState.m_Members.find(member.m_SteamID);
+		if (found == m_ModerationState.m_Members.end() || found->second.m_Team != member.m_Team)
+			MarkModerationStateDirty();
+
+		break;
+	}
+	case ConsoleLineType::LobbyChanged:
+	case ConsoleLineType::LobbyStatusFailed:
+		MarkModerationStateDirty();
+		break;
+	}
+}
+
 /// <summary>
 /// is this maybe from a different tf2bd instance?
 ///
@@ -342,6 +472,7 @@ void ModeratorLogic::OnChatMsg(IWorldState& world, IPlayer& player, const std::s
 
 	if (m_Settings->m_AutoMark && !botMsgDetected)
 	{
+		TFBD_PERF_SCOPE("Rules (chat)");
 		for (const ModerationRule& rule : m_Rules.GetRules())
 		{
 			if (!rule.Match(player, msg))
@@ -503,7 +634,7 @@ void ModeratorLogic::HandleFriendlyCheaters(uint8_t friendlyPlayerCount, uint8_t
 
 		if ((*cheater)->GetConnectionState() == PlayerStatusState::Active)
 		{
-			if (InitiateVotekick(cheater->m_Player, KickReason::Cheating, &cheater->m_Marks)) {
+			if (InitiateVotekick(*cheater->m_Player, KickReason::Cheating, &cheater->m_Marks)) {
 				kickAttemptedCount++;
 				break;
 			}
@@ -825,7 +956,7 @@ void ModeratorLogic::HandleConnectingMarkedPlayers(const std::vector<Cheater>& c
 		if (cheaterData.m_PartyWarned)
 			return;
 
-		tf2_bot_detector::IPlayer& player = unwarnedCheaters.at(0).m_Player.get();
+		tf2_bot_detector::IPlayer& player = *unwarnedCheaters.at(0).m_Player;
 		PlayerMarks marks = unwarnedCheaters.at(0).m_Marks;
 		SteamID steamid = player.GetSteamID();
 
@@ -869,7 +1000,7 @@ void ModeratorLogic::HandleConnectingMarkedPlayers(const std::vector<Cheater>& c
 			if (cheaterData.m_PartyWarned)
 				continue;
 
-			tf2_bot_detector::IPlayer& player = p.m_Player.get();
+			tf2_bot_detector::IPlayer& player = *p.m_Player;
 			PlayerMarks marks = p.m_Marks;
 			SteamID steamid = player.GetSteamID();
 
@@ -950,84 +1081,110 @@ void ModeratorLogic::ProcessPlayerActions()
 	if ((tfbd_clock_t::now() - now) > 15s)
 		return;
 
-	const auto myTeam = TryGetMyTeam();
-	if (!myTeam)
+	if (m_ModerationStateDirty || (now - m_LastModerationStateRebuild) >= MODERATION_STATE_MAX_AGE)
+		RebuildModerationState();
+
+	const ModerationState& state = m_ModerationState;
+	if (!state.m_MyTeam)
 		return; // We don't know what team we're on, so we can't really take any actions.
 
-	uint8_t totalEnemyPlayers = 0;
-	uint8_t connectedEnemyPlayers = 0;
-	uint8_t totalFriendlyPlayers = 0;
 	uint8_t connectedFriendlyPlayers = 0;
+	for (const auto& player : state.m_ConnectedFriendlyPlayers)
+	{
+		if (player->GetActiveTime() > m_Settings->GetAutoVotekickDelay())
+			connectedFriendlyPlayers++;
+	}
 
-	// all cheaters in lobby: used for m_IgnoreTeamStateOnCertainMaps.
-	std::vector<Cheater> allCheaters;
-	std::vector<Cheater> enemyCheaters;
-	std::vector<Cheater> friendlyCheaters;
-	std::vector<Cheater> connectingEnemyCheaters;
-	// the struct Cheater doesn't really have to be always a cheater (lol)
-	std::vector<Cheater> connectingMarkedPlayer;
+	HandleEnemyCheaters(state.m_TotalEnemyPlayers, state.m_EnemyCheaters, state.m_ConnectingEnemyCheaters);
+
+	// because we're in a map that swaps the teams around constantly, just ignore our own "team state" and try to call for everyone.
+	if (this->VoteKickIgnoresTeamState()) {
+		HandleFriendlyCheaters(state.m_TotalFriendlyPlayers + state.m_TotalEnemyPlayers,
+			connectedFriendlyPlayers + state.m_ConnectedEnemyPlayers, state.m_AllCheaters);
+	}
+	else {
+		HandleFriendlyCheaters(state.m_TotalFriendlyPlayers, connectedFriendlyPlayers, state.m_FriendlyCheaters);
+	}
+
+	HandleConnectingMarkedPlayers(state.m_ConnectingMarkedPlayers);
+}
+
+// Only keeps the marks (and the attributes within them) that match the given attributes
+static PlayerMarks FilterMarks(const PlayerMarks& marks, const PlayerAttributesList& attributes)
+{
+	PlayerMarks retVal;
+	for (const auto& mark : marks)
+	{
+		if (auto attr = mark.m_Attributes & attributes)
+			retVal.m_Marks.push_back({ attr, mark.m_FileName });
+	}
+
+	return retVal;
+}
+
+void ModeratorLogic::RebuildModerationState()
+{
+	ModerationState& state = m_ModerationState;
+	state = {};
+	state.m_MyTeam = TryGetMyTeam();
+	state.m_LobbyMemberCount = m_World->GetApproxLobbyMemberCount();
 
-	const bool isBotLeader = IsBotLeader();
-	bool needsEnemyWarning = false;
 	for (IPlayer& player : m_World->GetLobbyMembers())
 	{
+		const auto team = m_World->FindLobbyMemberTeam(player);
 		const bool isPlayerConnected = player.GetConnectionState() == PlayerStatusState::Active;
-		const auto isCheater = m_PlayerList.HasPlayerAttributes(player, PlayerAttribute::Cheater);
-		const bool isMarked = !m_PlayerList.GetPlayerAttributes(player).empty();
-		const auto teamShareResult = m_World->GetTeamShareResult(*myTeam, player);
+		const bool hasName = !player.GetNameSafe().empty();
 
-		if (isMarked && !isPlayerConnected)
-		{
-			connectingMarkedPlayer.push_back({ player, m_PlayerList.GetPlayerAttributes(player) });
-		}
+		state.m_Members.insert_or_assign(player.GetSteamID(),
+			ModerationState::MemberSnapshot{ team, player.GetConnectionState(), hasName });
+
+		if (!state.m_MyTeam)
+			continue; // Nothing is going to be done with the rest of this until we know our team
+
+		// Look up the marks once, rather than once per attribute we care about
+		const PlayerMarks marks = m_PlayerList.GetPlayerAttributes(player);
+		const PlayerMarks isCheater = FilterMarks(marks, PlayerAttribute::Cheater);
+
+		if (!marks.empty() && !isPlayerConnected)
+			state.m_ConnectingMarkedPlayers.push_back({ player, marks });
 
 		if (bool(isCheater))
-			allCheaters.push_back({ player, isCheater });
+			state.m_AllCheaters.push_back({ player, isCheater });
 
+		const auto teamShareResult = m_World->GetTeamShareResult(*state.m_MyTeam, team);
 		if (teamShareResult == TeamShareResult::SameTeams)
 		{
 			if (isPlayerConnected)
 			{
-				if (player.GetActiveTime() > m_Settings->GetAutoVotekickDelay())
-					connectedFriendlyPlayers++;
+				state.m_ConnectedFriendlyPlayers.push_back(player.shared_from_this());
 
 				if (bool(isCheater))
-					friendlyCheaters.push_back({ player, isCheater });
+					state.m_FriendlyCheaters.push_back({ player, isCheater });
 			}
 
-			totalFriendlyPlayers++;
+			state.m_TotalFriendlyPlayers++;
 		}
 		else if (teamShareResult == TeamShareResult::OppositeTeams)
 		{
 			if (isPlayerConnected)
 			{
-				connectedEnemyPlayers++;
+				state.m_ConnectedEnemyPlayers++;
 
-				if (isCheater && !player.GetNameSafe().empty())
-					enemyCheaters.push_back({ player, isCheater });
+				if (isCheater && hasName)
+					state.m_EnemyCheaters.push_back({ player, isCheater });
 			}
 			else
 			{
 				if (isCheater)
-					connectingEnemyCheaters.push_back({ player, isCheater });
+					state.m_ConnectingEnemyCheaters.push_back({ player, isCheater });
 			}
 
-			totalEnemyPlayers++;
+			state.m_TotalEnemyPlayers++;
 		}
 	}
 
-
-	HandleEnemyCheaters(totalEnemyPlayers, enemyCheaters, connectingEnemyCheaters);
-
-	// because we're in a map that swaps the teams around constantly, just ignore our own "team state" and try to call for everyone.
-	if (this->VoteKickIgnoresTeamState()) {
-		HandleFriendlyCheaters(totalFriendlyPlayers + totalEnemyPlayers, connectedFriendlyPlayers + connectedEnemyPlayers, allCheaters);
-	}
-	else {
-		HandleFriendlyCheaters(totalFriendlyPlayers, connectedFriendlyPlayers, friendlyCheaters);
-	}
-
-	HandleConnectingMarkedPlayers(connectingMarkedPlayer);
+	m_ModerationStateDirty = false;
+	m_LastModerationStateRebuild = m_World->GetCurrentTime();
 }
 
 bool ModeratorLogic::SetPlayerAttribute(const IPlayer& player, PlayerAttribute attribute, AttributePersistence persistence, bool set, std::string proof)
@@ -1072,6 +1229,12 @@ bool ModeratorLogic::SetPlayerAttribute(const SteamID& player, std::string name,
 			return ModifyPlayerAction::Modified;
 		});
 
+	if (attributeChanged)
+	{
+		m_PlayerAttributesVersion++;
+		MarkModerationStateDirty();
+	}
+
 	return attributeChanged;
 }
 
@@ -1155,59 +1318,109 @@ void ModeratorLogic::SetUserRunningTool(const SteamID& id, bool isRunningTool)
 MarkedFriends ModeratorLogic::GetMarkedFriendsCount(IPlayer& player) const
 {
 	auto& data = player.GetOrCreateData<PlayerExtraData>();
-	if (data.m_FriendsProcessed) {
-		return data.m_MarkedFriends;
-	}
-
-	auto friendsInfo = player.GetFriendsInfo();
 
-	// steamapi didn't get friends data yet; exit the function and this function will run again next loop.
-	if (!friendsInfo.has_value()) {
-		Log(player.GetSteamID().str() + " waiting until we receive friends list data for this player.");
-		return data.m_MarkedFriends;
-	}
+	if (!data.m_FriendAccountIDs)
+	{
+		const auto& friendsInfo = player.GetFriendsInfo();
 
-	uint32_t totalCount = 0;
-	uint32_t cheaterCount = 0;
-	uint32_t suspiciousCount = 0;
-	uint32_t exploiterCount = 0;
-	uint32_t racistCount = 0;
+		// steamapi didn't get friends data yet; exit the function and this function will run again next loop.
+		if (!friendsInfo.has_value()) {
+			Log(player.GetSteamID().str() + " waiting until we receive friends list data for this player.");
+			return data.m_MarkedFriends;
+		}
 
-	for (const SteamID& id : friendsInfo.value().m_Friends) {
-		auto playerAttributes = GetPlayerAttributes(id);
+		const auto& friends = friendsInfo.value().m_Friends;
 
-		if (!playerAttributes.empty())
+		std::vector<uint32_t> friendAccountIDs;
+		friendAccountIDs.reserve(friends.size());
+		for (const SteamID& id : friends)
 		{
-			// TODO: dont do this ig
-			if (playerAttributes.Has(PlayerAttribute::Cheater))
-				cheaterCount++;
-			if (playerAttributes.Has(PlayerAttribute::Suspicious))
-				suspiciousCount++;
-			if (playerAttributes.Has(PlayerAttribute::Exploiter))
-				exploiterCount++;
-			if (playerAttributes.Has(PlayerAttribute::Racist))
-				racistCount++;
-
-			totalCount++;
+			if (id.Type == SteamAccountType::Individual)
+				friendAccountIDs.push_back(id.GetAccountID());
 		}
+
+		std::sort(friendAccountIDs.begin(), friendAccountIDs.end());
+		friendAccountIDs.erase(std::unique(friendAccountIDs.begin(), friendAccountIDs.end()), friendAccountIDs.end());
+
+		data.m_MarkedFriends.m_FriendsCountTotal = static_cast<uint32_t>(friends.size());
+		data.m_FriendAccountIDs = friendAccountIDs;
+		data.m_FriendsProcessed = false;
+
+		BuildFriendsOfFriendsAsync(player, std::move(friendAccountIDs));
 	}
 
-	data.m_MarkedFriends.m_FriendsCountTotal = static_cast<uint32_t>(friendsInfo.value().m_Friends.size());
+	// Otherwise only recount if the player lists changed (or BuildFriendsOfFriendsAsync() finished)
+	const auto listVersion = m_PlayerList.GetAttributesVersion();
+	if (data.m_FriendsProcessed && data.m_MarkedFriendsListVersion == listVersion)
+		return data.m_MarkedFriends;
+
+	const MarkedAccountCounts counts = m_PlayerList.CountMarkedAccounts(*data.m_FriendAccountIDs);
+
+	for (auto attribute : { PlayerAttribute::Cheater, PlayerAttribute::Suspicious, PlayerAttribute::Exploiter, PlayerAttribute::Racist })
+		data.m_MarkedFriends.m_MarkedFriendsCount[attribute] = counts.GetCount(attribute);
+
+	data.m_MarkedFriends.m_MarkedFriendsCountTotal = counts.m_MarkedCount;
 
-	data.m_MarkedFriends.m_MarkedFriendsCount.insert(std::pair<PlayerAttribute, uint32_t>(PlayerAttribute::Cheater, cheaterCount));
-	data.m_MarkedFriends.m_MarkedFriendsCount.insert(std::pair<PlayerAttribute, uint32_t>(PlayerAttribute::Suspicious, suspiciousCount));
-	data.m_MarkedFriends.m_MarkedFriendsCount.insert(std::pair<PlayerAttribute, uint32_t>(PlayerAttribute::Exploiter, exploiterCount));
-	data.m_MarkedFriends.m_MarkedFriendsCount.insert(std::pair<PlayerAttribute, uint32_t>(PlayerAttribute::Racist, racistCount));
-	data.m_MarkedFriends.m_MarkedFriendsCountTotal = totalCount;
+	if (data.m_FriendsOfFriendsAccountIDs)
+	{
+		data.m_MarkedFriends.m_MarkedFriendsOfFriendsCountTotal =
+			m_PlayerList.CountMarkedAccounts(*data.m_FriendsOfFriendsAccountIDs).m_MarkedCount;
+	}
+
+	data.m_MarkedFriendsListVersion = listVersion;
 	data.m_FriendsProcessed = true;
 
 	return data.m_MarkedFriends;
 }
 
+void ModeratorLogic::BuildFriendsOfFriendsAsync(IPlayer& player, std::vector<uint32_t> friendAccountIDs) const
+{
+	// Bot networks tend to share friends, even when the bots themselves aren't friends with each other
+	[](std::shared_ptr<IPlayer> player, mh::thread_pool& pool, std::vector<uint32_t> friendAccountIDs) -> mh::task<>
+	{
+		try
+		{
+			co_await pool.co_add_task();
+
+			std::vector<uint32_t> friendsOfFriends;
+			const auto cachedListsCount = static_cast<uint32_t>(
+				TF2BDApplication::GetApplication().GetTempDB().GetCachedFriendAccountIDs(friendAccountIDs, friendsOfFriends));
+
+			std::sort(friendsOfFriends.begin(), friendsOfFriends.end());
+			friendsOfFriends.erase(std::unique(friendsOfFriends.begin(), friendsOfFriends.end()), friendsOfFriends.end());
+
+			// Only count accounts that are exactly two hops away
+			const uint32_t selfAccountID = player->GetSteamID().GetAccountID();
+			std::erase_if(friendsOfFriends, [&](uint32_t accountID)
+				{
+					return accountID == selfAccountID ||
+						std::binary_search(friendAccountIDs.begin(), friendAccountIDs.end(), accountID);
+				});
+
+			co_await GetDispatcher().co_dispatch();  // switch to main thread
+
+			auto& data = player->GetOrCreateData<PlayerExtraData>();
+			data.m_MarkedFriends.m_CachedFriendsListsCount = cachedListsCount;
+			data.m_MarkedFriends.m_FriendsOfFriendsCountTotal = static_cast<uint32_t>(friendsOfFriends.size());
+			data.m_FriendsOfFriendsAccountIDs = std::move(friendsOfFriends);
+			data.m_FriendsProcessed = false;
+
+			GetFrameScheduler().RequestFrame(WakeReason::World);
+		}
+		catch (...)
+		{
+			LogException();
+		}
+
+	}(player.shared_from_this(), m_FriendsGraphPool, std::move(friendAccountIDs));
+}
+
 void ModeratorLogic::ReloadConfigFiles()
 {
 	m_PlayerList.LoadFiles();
 	m_Rules.LoadFiles();
+	m_PlayerAttributesVersion++;
+	MarkModerationStateDirty();
 }
 
 ModeratorLogic::ModeratorLogic(IWorldState& world, const Settings& settings, RCONActionManager& actionManager) :
@@ -37,6 +37,11 @@ namespace tf2_bot_detector
 		std::unordered_map<PlayerAttribute, uint32_t> m_MarkedFriendsCount;
 		uint32_t m_MarkedFriendsCountTotal = 0;
 		uint32_t m_FriendsCountTotal = 0;
+
+		// Two hops out, using only friends lists already in the temp db (possibly from earlier sessions)
+		uint32_t m_MarkedFriendsOfFriendsCountTotal = 0;
+		uint32_t m_FriendsOfFriendsCountTotal = 0;
+		uint32_t m_CachedFriendsListsCount = 0; // Number of this player's friends with a cached friends list
 	};
 
 	class IModeratorLogic
@@ -54,6 +59,9 @@ namespace tf2_bot_detector
 		virtual PlayerMarks HasPlayerAttributes(const SteamID& id, const PlayerAttributesList& attributes,
 			AttributePersistence persistence = AttributePersistence::Any) const = 0;
 
+		// Changes whenever a player is marked/unmarked or the player lists are reloaded
+		virtual uint64_t GetPlayerAttributesVersion() const = 0;
+
 		virtual bool SetPlayerAttribute(const IPlayer& id, PlayerAttribute markType, AttributePersistence persistence, bool set = true, std::string proof = "") = 0;
 		virtual bool SetPlayerAttribute(const SteamID& id, std::string name, PlayerAttribute markType, AttributePersistence persistence, bool set = true, std::string proof = "") = 0;
 
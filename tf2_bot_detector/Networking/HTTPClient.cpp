@@ -6,9 +6,11 @@
 #include <mh/error/error_code_exception.hpp>
 #include <mh/text/case_insensitive_string.hpp>
 
+#include "FrameScheduler.h"
 #include "GlobalDispatcher.h"
 #include "HTTPClient.h"
 #include "HTTPHelpers.h"
+#include "Util/PerfCounters.h"
 
 #pragma warning(push, 1)
 #include <cpprest/http_client.h>
@@ -161,7 +163,7 @@ mh::task<std::string> HTTPClientImpl::GetStringAsync(URL url) const try
 
 				auto client = GetInnerClient(url);
 
-				const auto startTime = tfbd_clock_t::now();
+				const auto startTime = Perf::clock_type::now();
 
 				auto response = co_await client->request(web::http::methods::GET, utility::conversions::to_string_t(url.m_Path));
 
@@ -170,9 +172,14 @@ mh::task<std::string> HTTPClientImpl::GetStringAsync(URL url) const try
 
 				std::string stringResponse = co_await response.extract_utf8string(true);
 
-				const auto duration = tfbd_clock_t::now() - startTime;
+				const auto duration = Perf::clock_type::now() - startTime;
 				DebugLog("[{}ms] HTTP GET #{}: {}", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), requestIndex, url);
 
+				// Not a hot path, so just look the counter up every time
+				Perf::Record(Perf::RegisterCounter(mh::format("HTTP GET {}", url.m_Host)), startTime, duration);
+
+				GetFrameScheduler().RequestFrame(WakeReason::HTTP);
+
 				co_return std::move(stringResponse);
 			}
 			catch (...)
@@ -16,7 +16,8 @@
 #include <nlohmann/json.hpp>
 #include <stb_image.h>
 
-#include <fstream>
+#include <array>
+#include <mutex>
 #include <regex>
 
 using namespace std::chrono_literals;
@@ -43,23 +44,24 @@ namespace
 			DeleteOldFiles(m_CacheDir, 24h * 7);
 		}
 
-		mh::task<Bitmap> GetAvatarBitmap(const HTTPClient* client,
+		mh::task<std::shared_ptr<const Bitmap>> GetAvatarBitmap(const HTTPClient* client,
 			const std::string url, const std::string hash) const
 		{
 			const std::filesystem::path cachedPath = m_CacheDir / mh::fmtstr<128>("{}.jpg", hash).view();
 
-			// See if we're already stored in the cache
+			// Never touch the disk or decode on the calling (usually main) thread
+			co_await m_DecodePool.co_add_task();
+
+			// See if we're already stored in the cache. Files are only ever renamed into place once
+			// they are fully written, so there is no need to lock anything to read them.
+			try
 			{
-				std::lock_guard lock(m_CacheMutex);
-				try
-				{
-					if (std::filesystem::exists(cachedPath))
-						co_return Bitmap(cachedPath);
-				}
-				catch (const std::exception& e)
-				{
-					LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to load cached avatar from {}, re-fetching...", cachedPath);
-				}
+				if (std::filesystem::exists(cachedPath))
+					co_return std::make_shared<const Bitmap>(cachedPath);
+			}
+			catch (const std::exception& e)
+			{
+				LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to load cached avatar from {}, re-fetching...", cachedPath);
 			}
 
 			if (client)
@@ -69,22 +71,42 @@ namespace
 				// We're not stored in the cache, download now
 				std::string data = co_await clientPtr->GetStringAsync(url);
 
-				std::lock_guard lock(m_CacheMutex);
+				// Switch back off of the http client's thread before writing/decoding
+				co_await m_DecodePool.co_add_task();
+
+				try
+				{
+					// Only serializes writers of avatars that land in the same shard
+					std::lock_guard lock(GetShardMutex(hash));
+
+					// Checked write to a temp file, then renamed into place
+					IFilesystem::Get().WriteFile(cachedPath, data, PathUsage::WriteLocal);
+				}
+				catch (const std::exception& e)
 				{
-					std::ofstream file(cachedPath, std::ios::trunc | std::ios::binary);
-					file << data;
+					LogException(MH_SOURCE_LOCATION_CURRENT(), e, "Failed to write avatar to cache at {}", cachedPath);
 				}
-				co_return Bitmap(cachedPath);
+
+				Bitmap bitmap;
+				bitmap.LoadMemory(data);
+				co_return std::make_shared<const Bitmap>(std::move(bitmap));
 			}
 
 			// No HTTPClient and we're not in the cache, so just give up
-			co_return Bitmap{};
+			co_return std::make_shared<const Bitmap>();
 		}
 
 	private:
 		std::filesystem::path m_CacheDir;
-		mutable std::mutex m_CacheMutex;
 
+		std::mutex& GetShardMutex(const std::string_view& hash) const
+		{
+			return m_ShardMutexes[std::hash<std::string_view>{}(hash) % m_ShardMutexes.size()];
+		}
+		mutable std::array<std::mutex, 16> m_ShardMutexes;
+
+		// Disk io and jpeg decoding for avatars
+		mutable mh::thread_pool m_DecodePool{ 2 };
 	};
 
 	static AvatarCacheManager& GetAvatarCacheManager()
@@ -127,7 +149,7 @@ std::string PlayerSummary::GetAvatarURL(AvatarQuality quality) const
 		m_AvatarHash, qualityStr);
 }
 
-mh::task<Bitmap> PlayerSummary::GetAvatarBitmap(std::shared_ptr<const HTTPClient> client, AvatarQuality quality) const
+mh::task<std::shared_ptr<const Bitmap>> PlayerSummary::GetAvatarBitmap(std::shared_ptr<const HTTPClient> client, AvatarQuality quality) const
 {
 	return GetAvatarCacheManager().GetAvatarBitmap(client.get(), GetAvatarURL(quality), m_AvatarHash);
 }
@@ -8,6 +8,7 @@
 #include <mh/error/error_code_exception.hpp>
 #include <nlohmann/json_fwd.hpp>
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_set>
@@ -99,7 +100,8 @@ namespace tf2_bot_detector::SteamAPI
 		std::optional<duration_t> GetAccountAge() const;
 
 		std::string GetAvatarURL(AvatarQuality quality = AvatarQuality::Large) const;
-		mh::task<Bitmap> GetAvatarBitmap(std::shared_ptr<const IHTTPClient> client,
+		// Shared, so whoever ends up uploading it can keep it alive for as long as it needs
+		mh::task<std::shared_ptr<const Bitmap>> GetAvatarBitmap(std::shared_ptr<const IHTTPClient> client,
 			AvatarQuality quality = AvatarQuality::Large) const;
 
 		std::string_view GetVanityURL() const;
@@ -0,0 +1,99 @@
+#include "FileWatcher.h"
+#include "Log.h"
+
+#include <mh/text/formatters/error_code.hpp>
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// inotify can't watch a file that doesn't exist yet, and a watch on a file follows
+	// its inode rather than its name. Watching the parent directory instead sees the file
+	// being created, deleted or replaced, as well as every write to it.
+	class InotifyFileWatcher final : public IFileWatcher
+	{
+	public:
+		InotifyFileWatcher(int fd, std::string fileName) : m_FD(fd), m_FileName(std::move(fileName)) {}
+		~InotifyFileWatcher() override { close(m_FD); }
+
+		InotifyFileWatcher(const InotifyFileWatcher&) = delete;
+		InotifyFileWatcher& operator=(const InotifyFileWatcher&) = delete;
+
+		FileChanges Poll() override;
+
+	private:
+		int m_FD = -1;
+		std::string m_FileName;
+	};
+
+	FileChanges InotifyFileWatcher::Poll()
+	{
+		FileChanges changes;
+
+		alignas(inotify_event) char buf[4096];
+		while (true)
+		{
+			const auto length = read(m_FD, buf, sizeof(buf));
+			if (length <= 0)
+			{
+				if (length < 0 && errno != EAGAIN && errno != EINTR)
+					LogError(MH_SOURCE_LOCATION_CURRENT(), "Failed to read inotify events: {}", std::error_code(errno, std::generic_category()));
+
+				break;
+			}
+
+			for (const char* ptr = buf; ptr < (buf + length); )
+			{
+				const auto& event = *reinterpret_cast<const inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event.len;
+
+				if (event.mask & IN_Q_OVERFLOW)
+				{
+					// We lost events. Reporting a modification gets the file re-checked for new
+					// data and truncation, without making the reader throw away its position.
+					changes.m_Modified = true;
+					continue;
+				}
+
+				if (event.len == 0 || m_FileName != event.name)
+					continue;
+
+				if (event.mask & IN_MODIFY)
+					changes.m_Modified = true;
+				if (event.mask & (IN_CREATE | IN_MOVED_TO))
+					changes.m_Created = true;
+				if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+					changes.m_Removed = true;
+			}
+		}
+
+		return changes;
+	}
+}
+
+std::unique_ptr<IFileWatcher> tf2_bot_detector::Platform::CreateNativeFileWatcher(const std::filesystem::path& path)
+{
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0)
+	{
+		LogWarning("Failed to initialize inotify: {}", std::error_code(errno, std::generic_category()));
+		return nullptr;
+	}
+
+	const auto dir = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+	if (inotify_add_watch(fd, dir.c_str(), IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0)
+	{
+		LogWarning("Failed to watch {} for changes: {}", dir, std::error_code(errno, std::generic_category()));
+		close(fd);
+		return nullptr;
+	}
+
+	return std::make_unique<InotifyFileWatcher>(fd, path.filename().string());
+}
@@ -1,29 +1,396 @@
 #include "../Platform.h"
-#include "Util/TextUtils.h"
+#include "Clock.h"
 #include "Log.h"
 
-#include <mh/coroutine/future.hpp>
-#include <mh/memory/cached_variable.hpp>
 #include <mh/error/ensure.hpp>
-#include <mh/text/case_insensitive_string.hpp>
-#include <mh/text/codecvt.hpp>
 #include <mh/text/formatters/error_code.hpp>
-#include <mh/text/insertion_conversion.hpp>
 #include <mh/text/string_insertion.hpp>
 
-#include <atomic>
-#include <cassert>
-#include <chrono>
-#include <exception>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <optional>
+#include <string>
+#include <system_error>
 #include <unordered_map>
+#include <vector>
 
-#include <Windows.h>
-#include <shellapi.h>
-#include "WindowsHelpers.h"
-#include <comutil.h>
-#include <Wbemidl.h>
-#include <TlHelp32.h>
-#include <wrl/client.h>
-#include <Psapi.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+using namespace std::chrono_literals;
+using namespace std::string_literals;
+using namespace tf2_bot_detector;
+
+#ifdef _DEBUG
+namespace tf2_bot_detector
+{
+	extern bool g_SkipOpenTF2Check;
+}
+#endif
+
+namespace
+{
+	// /proc/<pid>/comm is truncated to this many characters
+	static constexpr size_t MAX_COMM_LENGTH = 15;
+
+	// While a process isn't running, don't walk all of /proc more often than this
+	static constexpr duration_t RESCAN_INTERVAL = 1s;
+
+	static const std::vector<std::string> TF2_PROCESS_NAMES = { "tf_linux64", "hl2_linux" };
+
+	static std::error_code GetErrnoCode()
+	{
+		return std::error_code(errno, std::generic_category());
+	}
+
+	// Reads a small file in /proc, which doesn't report a size, in one go
+	static bool ReadProcFile(const char* path, std::string& contents)
+	{
+		const int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		contents.clear();
+
+		char buf[4096];
+		ssize_t length;
+		while ((length = read(fd, buf, sizeof(buf))) > 0)
+			contents.append(buf, size_t(length));
+
+		close(fd);
+		return length == 0;
+	}
+
+	static std::string GetComm(pid_t pid)
+	{
+		std::string comm;
+		if (!ReadProcFile(mh::format("/proc/{}/comm", pid).c_str(), comm))
+			return {};
+
+		if (!comm.empty() && comm.back() == '\n')
+			comm.pop_back();
+
+		return comm;
+	}
+
+	static bool IsProcessNameMatch(const std::string_view& comm, const std::vector<std::string>& names)
+	{
+		for (const auto& name : names)
+		{
+			if (comm == std::string_view(name).substr(0, MAX_COMM_LENGTH))
+				return true;
+		}
+
+		return false;
+	}
+
+	// Calls func(pid) for every running process with one of the given names, until it returns false
+	template<typename TFunc>
+	static void ForEachProcess(const std::vector<std::string>& names, TFunc&& func)
+	{
+		DIR* dir = opendir("/proc");
+		if (!dir)
+		{
+			LogError(MH_SOURCE_LOCATION_CURRENT(), "Failed to open /proc: {}", GetErrnoCode());
+			return;
+		}
+
+		while (const dirent* entry = readdir(dir))
+		{
+			char* end;
+			const auto pid = pid_t(std::strtol(entry->d_name, &end, 10));
+			if (pid <= 0 || *end != '\0')
+				continue; // Not a process
+
+			if (IsProcessNameMatch(GetComm(pid), names) && !func(pid))
+				break;
+		}
+
+		closedir(dir);
+	}
+
+	// Remembers the pid of a process once it's been found, and keeps a pidfd to it so
+	// checking if it is still running is a single poll() instead of another walk of /proc.
+	class ProcessWatcher final
+	{
+	public:
+		explicit ProcessWatcher(std::vector<std::string> names) : m_Names(std::move(names)) {}
+		~ProcessWatcher() { Reset(); }
+
+		ProcessWatcher(const ProcessWatcher&) = delete;
+		ProcessWatcher& operator=(const ProcessWatcher&) = delete;
+
+		bool IsRunning();
+
+	private:
+		bool IsAlive() const;
+		void Reset();
+
+		std::vector<std::string> m_Names;
+		pid_t m_PID = 0;
+		int m_PIDFD = -1;
+		std::optional<time_point_t> m_LastScanTime;
+	};
+
+	bool ProcessWatcher::IsRunning()
+	{
+		if (m_PID != 0)
+		{
+			if (IsAlive())
+				return true;
+
+			Reset();
+		}
+
+		const auto now = tfbd_clock_t::now();
+		if (m_LastScanTime && (now - *m_LastScanTime) < RESCAN_INTERVAL)
+			return false;
+
+		m_LastScanTime = now;
+
+		ForEachProcess(m_Names, [&](pid_t pid)
+			{
+				m_PID = pid;
+#ifdef SYS_pidfd_open
+				m_PIDFD = int(syscall(SYS_pidfd_open, pid, 0));
+				if (m_PIDFD < 0 && errno != ENOSYS)
+					DebugLog("pidfd_open({}) failed: {}", pid, GetErrnoCode());
+#endif
+				return false;
+			});
+
+		// Make sure the pid didn't get reused between finding it and opening the pidfd
+		if (m_PID != 0 && !IsProcessNameMatch(GetComm(m_PID), m_Names))
+			Reset();
+
+		return m_PID != 0;
+	}
+
+	bool ProcessWatcher::IsAlive() const
+	{
+		if (m_PIDFD >= 0)
+		{
+			// A pidfd becomes readable once the process exits
+			pollfd pfd{};
+			pfd.fd = m_PIDFD;
+			pfd.events = POLLIN;
+			return poll(&pfd, 1, 0) == 0;
+		}
+
+		// Kernels older than 5.3 don't have pidfds, and the pid might have been reused
+		return (kill(m_PID, 0) == 0 || errno == EPERM) && IsProcessNameMatch(GetComm(m_PID), m_Names);
+	}
+
+	void ProcessWatcher::Reset()
+	{
+		if (m_PIDFD >= 0)
+			close(m_PIDFD);
+
+		m_PIDFD = -1;
+		m_PID = 0;
+	}
+
+	struct ProcessWatchers
+	{
+		std::mutex m_Mutex;
+		ProcessWatcher m_TF2{ TF2_PROCESS_NAMES };
+		ProcessWatcher m_Steam{ std::vector<std::string>{ "steam" } };
+		std::unordered_map<std::string, std::unique_ptr<ProcessWatcher>> m_Others;
+
+		// Command lines don't change while a process is running, so only read them once per pid
+		std::unordered_map<pid_t, std::string> m_TF2CommandLines;
+
+		// Children from Launch(). Nobody waits on them, so they have to be reaped here once
+		// they exit or they'd stick around as zombies until we do.
+		std::vector<pid_t> m_LaunchedPIDs;
+		void ReapLaunchedProcesses();
+
+		static ProcessWatchers& Get()
+		{
+			static ProcessWatchers s_Watchers;
+			return s_Watchers;
+		}
+	};
+
+	void ProcessWatchers::ReapLaunchedProcesses()
+	{
+		std::erase_if(m_LaunchedPIDs, [](pid_t pid)
+			{
+				// Only ever waits on our own children, so this can't steal anyone else's exit status
+				const pid_t result = waitpid(pid, nullptr, WNOHANG);
+				return result == pid || (result < 0 && errno == ECHILD);
+			});
+	}
+
+	// Quotes arguments the same way Shell::SplitCommandLineArgs() expects
+	static std::string ReadCommandLine(pid_t pid)
+	{
+		std::string raw;
+		if (!ReadProcFile(mh::format("/proc/{}/cmdline", pid).c_str(), raw))
+			return {};
+
+		std::string cmdLine;
+		for (size_t begin = 0; begin < raw.size(); )
+		{
+			auto end = raw.find('\0', begin);
+			if (end == raw.npos)
+				end = raw.size();
+
+			const std::string_view arg(raw.data() + begin, end - begin);
+
+			if (!cmdLine.empty())
+				cmdLine += ' ';
+
+			if (arg.empty() || arg.find_first_of(" \t\"") != arg.npos)
+				cmdLine << std::quoted(arg);
+			else
+				cmdLine += arg;
+
+			begin = end + 1;
+		}
+
+		return cmdLine;
+	}
+}
+
+bool tf2_bot_detector::Processes::IsTF2Running()
+{
+	auto& watchers = ProcessWatchers::Get();
+	std::lock_guard lock(watchers.m_Mutex);
+
+	// Polled regularly, so a good place to clean up after anything we launched
+	watchers.ReapLaunchedProcesses();
+
+	return watchers.m_TF2.IsRunning();
+}
+
+mh::task<std::vector<std::string>> tf2_bot_detector::Processes::GetTF2CommandLineArgsAsync()
+{
+	std::vector<std::string> retVal;
+
+	{
+		auto& watchers = ProcessWatchers::Get();
+		std::lock_guard lock(watchers.m_Mutex);
+		watchers.ReapLaunchedProcesses();
+
+		// Still walk all of /proc, this isn't called every frame and we need to know about multiple instances
+		decltype(watchers.m_TF2CommandLines) commandLines;
+		ForEachProcess(TF2_PROCESS_NAMES, [&](pid_t pid)
+			{
+				auto& cmdLine = commandLines[pid];
+				if (auto found = watchers.m_TF2CommandLines.find(pid); found != watchers.m_TF2CommandLines.end())
+					cmdLine = std::move(found->second);
+				else
+					cmdLine = ReadCommandLine(pid);
+
+				retVal.push_back(cmdLine);
+				return true;
+			});
+
+		watchers.m_TF2CommandLines = std::move(commandLines);
+	}
+
+	co_return retVal;
+}
+
+bool tf2_bot_detector::Processes::IsSteamRunning()
+{
+	auto& watchers = ProcessWatchers::Get();
+	std::lock_guard lock(watchers.m_Mutex);
+	return watchers.m_Steam.IsRunning();
+}
+
+bool tf2_bot_detector::Processes::IsProcessRunning(const std::string_view& processName)
+{
+	auto& watchers = ProcessWatchers::Get();
+	std::lock_guard lock(watchers.m_Mutex);
+
+	auto& watcher = watchers.m_Others[std::string(processName)];
+	if (!watcher)
+		watcher = std::make_unique<ProcessWatcher>(std::vector<std::string>{ std::string(processName) });
+
+	return watcher->IsRunning();
+}
+
+void tf2_bot_detector::Processes::RequireTF2NotRunning()
+{
+	if (!IsTF2Running())
+		return;
+
+#ifdef _DEBUG
+	if (g_SkipOpenTF2Check)
+	{
+		LogWarning("TF2 was found running, but --allow-open-tf2 was on the command line. Letting execution proceed.");
+	}
+	else
+#endif
+	{
+		LogError("TF2 Bot Detector must be started before Team Fortress 2.");
+		std::exit(1);
+	}
+}
+
+void tf2_bot_detector::Processes::Launch(const std::filesystem::path& executable,
+	const std::vector<std::string>& args, bool elevated)
+{
+	DebugLog("posix_spawn({}, {} args) (elevated = {})", executable, args.size(), elevated);
+
+	if (elevated)
+		LogWarning("Launching elevated processes is not supported on Linux, launching {} normally", executable);
+
+	std::vector<char*> argv;
+	argv.push_back(const_cast<char*>(executable.c_str()));
+	for (const auto& arg : args)
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	argv.push_back(nullptr);
+
+	pid_t pid;
+	if (const int result = posix_spawn(&pid, executable.c_str(), nullptr, nullptr, argv.data(), environ); result != 0)
+	{
+		auto exception = std::system_error(result, std::generic_category(), mh::format("Failed to launch {}", executable));
+		LogException(MH_SOURCE_LOCATION_CURRENT(), exception);
+		throw exception;
+	}
+
+	auto& watchers = ProcessWatchers::Get();
+	std::lock_guard lock(watchers.m_Mutex);
+	watchers.ReapLaunchedProcesses();
+	watchers.m_LaunchedPIDs.push_back(pid);
+}
+
+void tf2_bot_detector::Processes::Launch(const std::filesystem::path& executable,
+	const std::string_view& args, bool elevated)
+{
+	return Launch(executable, Shell::SplitCommandLineArgs(args), elevated);
+}
+
+int tf2_bot_detector::Processes::GetCurrentProcessID()
+{
+	return getpid();
+}
+
+size_t tf2_bot_detector::Processes::GetCurrentRAMUsage()
+{
+	// Second field is the resident set size, in pages
+	std::string statm;
+	if (!mh_ensure(ReadProcFile("/proc/self/statm", statm)))
+		return 0;
+
+	size_t totalPages = 0, residentPages = 0;
+	if (!mh_ensure(std::sscanf(statm.c_str(), "%zu %zu", &totalPages, &residentPages) == 2))
+		return 0;
+
+	return residentPages * size_t(sysconf(_SC_PAGESIZE));
+}
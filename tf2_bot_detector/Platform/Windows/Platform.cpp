@@ -1,4 +1,5 @@
 #include "Platform/Platform.h"
+#include "FileWatcher.h"
 #include "Log.h"
 #include "WindowsHelpers.h"
 
@@ -137,3 +138,10 @@ bool tf2_bot_detector::Platform::IsPortAvailable(uint16_t port)
 
 	return true;
 }
+
+std::unique_ptr<tf2_bot_detector::IFileWatcher> tf2_bot_detector::Platform::CreateNativeFileWatcher(const std::filesystem::path& path)
+{
+	// Directory change notifications have the same lazy size update problem as polling
+	// does for a file another process is writing to, so they don't buy us anything here.
+	return nullptr;
+}
@@ -1,25 +1,134 @@
 #include "SteamID.h"
-#include "Util/RegexUtils.h"
 
 #include <mh/text/format.hpp>
 #include <nlohmann/json.hpp>
 
-#include <regex>
+#include <algorithm>
+#include <charconv>
+#include <optional>
 #include <stdexcept>
 
 using namespace std::string_literals;
 using namespace tf2_bot_detector;
 
+namespace
+{
+	// Plain ASCII versions, std::isdigit/std::isspace are locale dependent and
+	// undefined for negative chars.
+	constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+	constexpr bool IsSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+	constexpr bool IsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+	// Consumes one or more digits from the front of str
+	std::string_view TakeDigits(std::string_view& str)
+	{
+		size_t count = 0;
+		while (count < str.size() && IsDigit(str[count]))
+			count++;
+
+		const auto digits = str.substr(0, count);
+		str.remove_prefix(count);
+		return digits;
+	}
+
+	template<typename T>
+	bool ParseDigits(const std::string_view& digits, T& out)
+	{
+		const auto result = std::from_chars(digits.data(), digits.data() + digits.size(), out);
+		return result.ec == std::errc{} && result.ptr == digits.data() + digits.size();
+	}
+
+	// The pieces of "[T:U:ID]" or "[T:U:ID:INSTANCE]"
+	struct SteamID3Parts
+	{
+		char m_Type;
+		std::string_view m_Universe;
+		std::string_view m_ID;
+		std::string_view m_Instance;
+	};
+
+	std::optional<SteamID3Parts> SplitSteamID3(std::string_view str)
+	{
+		// Shortest possible is "[U:1:2]"
+		if (str.size() < 7 || str.front() != '[' || str.back() != ']')
+			return std::nullopt;
+
+		str.remove_prefix(1);
+		str.remove_suffix(1);
+
+		SteamID3Parts parts{};
+
+		parts.m_Type = str[0];
+		if (!IsAlpha(parts.m_Type) || str[1] != ':' || !IsDigit(str[2]) || str[3] != ':')
+			return std::nullopt;
+
+		parts.m_Universe = str.substr(2, 1);
+		str.remove_prefix(4);
+
+		if (parts.m_ID = TakeDigits(str); parts.m_ID.empty())
+			return std::nullopt;
+
+		if (!str.empty())
+		{
+			if (str.front() != ':')
+				return std::nullopt;
+
+			str.remove_prefix(1);
+			if (parts.m_Instance = TakeDigits(str); parts.m_Instance.empty() || !str.empty())
+				return std::nullopt;
+		}
+
+		return parts;
+	}
+
+	// "STEAM_X:Y:Z", where the account id is Z * 2 + Y
+	std::optional<SteamID> ParseSteamID2(const std::string_view& input)
+	{
+		constexpr std::string_view PREFIX = "STEAM_";
+		if (!input.starts_with(PREFIX))
+			return std::nullopt;
+
+		std::string_view str = input.substr(PREFIX.size());
+
+		const auto universeStr = TakeDigits(str);
+		if (universeStr.empty() || str.empty() || str.front() != ':')
+			throw std::invalid_argument(mh::format("Invalid SteamID2: {}", input));
+
+		str.remove_prefix(1);
+		const auto yStr = TakeDigits(str);
+		if (yStr.size() != 1 || (yStr[0] != '0' && yStr[0] != '1') || str.empty() || str.front() != ':')
+			throw std::invalid_argument(mh::format("Invalid SteamID2: {}", input));
+
+		str.remove_prefix(1);
+		const auto zStr = TakeDigits(str);
+		if (zStr.empty() || !str.empty())
+			throw std::invalid_argument(mh::format("Invalid SteamID2: {}", input));
+
+		uint32_t universe;
+		if (!ParseDigits(universeStr, universe) || universe > 0xFF)
+			throw std::invalid_argument(mh::format("Out-of-range value for SteamID2 universe: {}", universeStr));
+
+		uint32_t z;
+		if (!ParseDigits(zStr, z) || z > (UINT32_MAX >> 1))
+			throw std::invalid_argument(mh::format("Out-of-range value for SteamID2 account number: {}", zStr));
+
+		// Old games (including TF2's engine branch) print universe 0 for public accounts
+		if (universe == 0)
+			universe = static_cast<uint32_t>(SteamAccountUniverse::Public);
+
+		return SteamID((z << 1) | uint32_t(yStr[0] - '0'), SteamAccountType::Individual,
+			static_cast<SteamAccountUniverse>(universe));
+	}
+}
+
 SteamID::SteamID(const std::string_view& str)
 {
 	ID64 = 0;
 
 	// Steam3
-	static std::regex s_SteamID3Regex(R"regex(\[([a-zA-Z]):(\d):(\d+)(?::(\d+))?\])regex", std::regex::optimize);
-	if (std::match_results<std::string_view::const_iterator> result;
-		std::regex_match(str.begin(), str.end(), result, s_SteamID3Regex))
+	if (const auto parts = SplitSteamID3(str))
 	{
-		const char firstChar = *result[1].first;
+		const char firstChar = parts->m_Type;
 		switch (firstChar)
 		{
 		case 'U': Type = SteamAccountType::Individual; break;
@@ -46,25 +155,25 @@ SteamID::SteamID(const std::string_view& str)
 
 		{
 			uint32_t universe;
-			if (auto parseResult = from_chars(result[2], universe); !parseResult)
-				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 universe: {}", result[2].str()));
+			if (!ParseDigits(parts->m_Universe, universe))
+				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 universe: {}", parts->m_Universe));
 
 			Universe = static_cast<SteamAccountUniverse>(universe);
 		}
 
 		{
 			uint32_t id;
-			if (auto parseResult = from_chars(result[3], id); !parseResult)
-				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 ID: {}", result[3].str()));
+			if (!ParseDigits(parts->m_ID, id))
+				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 ID: {}", parts->m_ID));
 
 			ID = id;
 		}
 
-		if (result[4].matched)
+		if (!parts->m_Instance.empty())
 		{
 			uint32_t instance;
-			if (auto parseResult = from_chars(result[4], instance); !parseResult)
-				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 account instance: {}", result[4].str()));
+			if (!ParseDigits(parts->m_Instance, instance))
+				throw std::invalid_argument(mh::format("Out-of-range value for SteamID3 account instance: {}", parts->m_Instance));
 
 			Instance = static_cast<SteamAccountInstance>(instance);
 		}
@@ -76,11 +185,19 @@ SteamID::SteamID(const std::string_view& str)
 		return;
 	}
 
+	// Steam2
+	if (const auto steamID2 = ParseSteamID2(str))
+	{
+		*this = *steamID2;
+		return;
+	}
+
 	// Steam64
-	if (std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit(c) || std::isspace(c); }))
+	if (std::all_of(str.begin(), str.end(), [](char c) { return IsDigit(c) || IsSpace(c); }))
 	{
+		// Trailing whitespace is ignored, leading whitespace is not
 		uint64_t result;
-		if (auto parseResult = mh::from_chars(str, result); !parseResult)
+		if (const auto parseResult = std::from_chars(str.data(), str.data() + str.size(), result); parseResult.ec != std::errc{})
 			throw std::invalid_argument(mh::format("Out-of-range SteamID64: {}", str));
 
 		ID64 = result;
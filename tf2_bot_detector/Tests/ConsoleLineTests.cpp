@@ -109,6 +109,18 @@ namespace
 		{
 			throw mh::not_implemented_error();
 		}
+		virtual size_t GetPlayerDataCount() const override
+		{
+			throw mh::not_implemented_error();
+		}
+		virtual uint64_t GetPlayerDataVersion() const override
+		{
+			throw mh::not_implemented_error();
+		}
+		virtual size_t GetApproxPlayerDataMemoryUsage() const override
+		{
+			throw mh::not_implemented_error();
+		}
 
 	} static s_DummyWorldState;
 }
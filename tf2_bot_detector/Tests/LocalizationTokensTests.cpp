@@ -0,0 +1,47 @@
+#include "Config/LocalizationTokens.h"
+
+#include <catch2/catch.hpp>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+static constexpr std::string_view TEST_FILE = R"(
+"lang"
+{
+	"Language"	"English"
+	"TF_Chat_NotInTokens"	"ignored"
+	"Tokens"
+	{
+		// a comment "TF_Chat_Comment" "ignored"
+		"TF_Chat_Team"		"(TEAM) %s1 :  %s2"
+		"TF_Chat_All"		"%s1 :  %s2"
+		"TF_Chat_Quoted"	"a \"quoted\" \\ value\n"
+		"TF_Chat_X360"		"ignored"	[$X360]
+		"TF_Chat_NotX360"	"kept"	[!$X360]
+		"Something_Else"	"ignored"
+		"Nested"
+		{
+			"TF_Chat_Nested"	"ignored"
+		}
+		"TF_Chat_All"		"duplicate"
+	}
+}
+)";
+
+TEST_CASE("tf2bd_localization_tokens", "[tf2bd]")
+{
+	const LocalizationTokens expected =
+	{
+		{ "TF_Chat_Team", "(TEAM) %s1 :  %s2" },
+		{ "TF_Chat_All", "%s1 :  %s2" },
+		{ "TF_Chat_Quoted", R"(a "quoted" \ value\n)" },
+		{ "TF_Chat_NotX360", "kept" },
+		{ "TF_Chat_All", "duplicate" },
+	};
+
+	REQUIRE(ScanLocalizationTokens(TEST_FILE, "TF_Chat_"sv) == expected);
+
+	const std::u16string wideFile(TEST_FILE.begin(), TEST_FILE.end());
+	REQUIRE(ScanLocalizationTokens(std::u16string_view(wideFile), "TF_Chat_"sv) == expected);
+}
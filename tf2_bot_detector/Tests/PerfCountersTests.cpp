@@ -0,0 +1,65 @@
+#include "Util/PerfCounters.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	const Perf::CounterStats* FindCounter(const std::vector<Perf::CounterStats>& stats, const std::string_view& name)
+	{
+		auto found = std::find_if(stats.begin(), stats.end(), [&](const Perf::CounterStats& s) { return s.m_Name == name; });
+		return found != stats.end() ? &*found : nullptr;
+	}
+}
+
+TEST_CASE("tf2bd_perf_counters", "[tf2bd]")
+{
+	const auto id = Perf::RegisterCounter("Test Counter");
+	REQUIRE(id != Perf::INVALID_COUNTER);
+	REQUIRE(Perf::RegisterCounter("Test Counter") == id);
+
+	Perf::ResetCounters();
+
+	const auto now = Perf::clock_type::now();
+	Perf::Record(id, now, 2ms);
+
+	// Samples from other threads are merged into the same counter
+	std::thread([&] { Perf::Record(id, now, 5ms); }).join();
+
+	{
+		const auto stats = Perf::GetSnapshot();
+		const auto counter = FindCounter(stats, "Test Counter");
+		REQUIRE(counter);
+		REQUIRE(counter->m_Count == 2);
+		REQUIRE(counter->m_Total == 7ms);
+		REQUIRE(counter->m_Max == 5ms);
+	}
+
+	Perf::ResetCounters();
+
+	{
+		const auto stats = Perf::GetSnapshot();
+		const auto counter = FindCounter(stats, "Test Counter");
+		REQUIRE(counter);
+		REQUIRE(counter->m_Count == 0);
+		REQUIRE(counter->m_Max == 0ms);
+	}
+
+	// Recording to the overflow id is a no-op
+	{
+		const auto countersBefore = Perf::GetSnapshot().size();
+		Perf::Record(Perf::INVALID_COUNTER, now, 1ms);
+
+		const auto stats = Perf::GetSnapshot();
+		REQUIRE(stats.size() == countersBefore);
+
+		const auto counter = FindCounter(stats, "Test Counter");
+		REQUIRE(counter);
+		REQUIRE(counter->m_Count == 0);
+	}
+}
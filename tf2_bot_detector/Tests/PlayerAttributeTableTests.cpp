@@ -0,0 +1,71 @@
+#include "Config/PlayerListJSON.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace tf2_bot_detector;
+
+TEST_CASE("tf2bd_player_attribute_table_find", "[tf2bd]")
+{
+	PlayerAttributeTable table;
+	table.Add(300, PlayerAttribute::Cheater);
+	table.Add(100, PlayerAttribute::Racist);
+	table.Add(300, PlayerAttribute::Exploiter);
+	table.Add(200, {});
+	table.Finalize();
+
+	REQUIRE(table.size() == 2);
+	REQUIRE(table.Find(100) == PlayerAttributesList(PlayerAttribute::Racist));
+	REQUIRE(table.Find(300) == (PlayerAttribute::Cheater | PlayerAttribute::Exploiter));
+	REQUIRE(table.Find(200).empty());
+	REQUIRE(table.Find(400).empty());
+}
+
+TEST_CASE("tf2bd_player_attribute_table_count", "[tf2bd]")
+{
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<uint32_t> accountIDs(1, 5000);
+	std::uniform_int_distribution<unsigned> attributeBits(0, (1 << size_t(PlayerAttribute::COUNT)) - 1);
+
+	PlayerAttributeTable table;
+	for (size_t i = 0; i < 2000; i++)
+		table.Add(accountIDs(random), PlayerAttributesList(PlayerAttributesList::bits_t(attributeBits(random))));
+
+	table.Finalize();
+
+	// Small enough to binary search, and big enough to walk both
+	for (size_t friendCount : { 50, 1000 })
+	{
+		std::vector<uint32_t> friends;
+		while (friends.size() < friendCount)
+		{
+			if (auto id = accountIDs(random); std::find(friends.begin(), friends.end(), id) == friends.end())
+				friends.push_back(id);
+		}
+
+		std::sort(friends.begin(), friends.end());
+
+		MarkedAccountCounts expected;
+		for (uint32_t id : friends)
+		{
+			const auto attributes = table.Find(id);
+			if (attributes.empty())
+				continue;
+
+			expected.m_MarkedCount++;
+			for (size_t attr = 0; attr < size_t(PlayerAttribute::COUNT); attr++)
+			{
+				if (attributes.HasAttribute(PlayerAttribute(attr)))
+					expected.m_AttributeCounts[attr]++;
+			}
+		}
+
+		const auto counts = table.Count(friends);
+		CAPTURE(friendCount);
+		REQUIRE(counts.m_MarkedCount == expected.m_MarkedCount);
+		REQUIRE(counts.m_AttributeCounts == expected.m_AttributeCounts);
+	}
+}
@@ -79,11 +79,7 @@ namespace
 		{
 			throw mh::not_implemented_error();
 		}
-		std::any& GetOrCreateDataStorage(const std::type_index& type) override
-		{
-			throw mh::not_implemented_error();
-		}
-		const std::any* FindDataStorage(const std::type_index& type) const override
+		size_t GetApproxMemoryUsage() const override
 		{
 			throw mh::not_implemented_error();
 		}
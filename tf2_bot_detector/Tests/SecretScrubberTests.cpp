@@ -0,0 +1,83 @@
+#include "Util/SecretScrubber.h"
+
+#include <catch2/catch.hpp>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	std::string Scrub(const SecretScrubber& scrubber, std::string str)
+	{
+		scrubber.Replace(str);
+		return str;
+	}
+}
+
+TEST_CASE("tf2bd_secret_scrubber", "[tf2bd]")
+{
+	SECTION("No secrets")
+	{
+		REQUIRE(Scrub({}, "hello world") == "hello world");
+	}
+
+	const auto scrubber = SecretScrubber{}
+		.WithSecret("hunter2", "<PASSWORD>")
+		.WithSecret("ABCDEF", "<KEY>");
+
+	SECTION("Single secrets")
+	{
+		REQUIRE(Scrub(scrubber, "") == "");
+		REQUIRE(Scrub(scrubber, "hunter2") == "<PASSWORD>");
+		REQUIRE(Scrub(scrubber, "rcon_password hunter2;") == "rcon_password <PASSWORD>;");
+		REQUIRE(Scrub(scrubber, "key=ABCDEF&pass=hunter2") == "key=<KEY>&pass=<PASSWORD>");
+		REQUIRE(Scrub(scrubber, "hunter hunter1 ABCDE") == "hunter hunter1 ABCDE");
+	}
+
+	SECTION("Adjacent secrets")
+	{
+		REQUIRE(Scrub(scrubber, "hunter2ABCDEF") == "<PASSWORD><KEY>");
+		REQUIRE(Scrub(scrubber, "hunter2hunter2") == "<PASSWORD><PASSWORD>");
+	}
+
+	SECTION("Replacing an existing secret's replacement")
+	{
+		REQUIRE(Scrub(scrubber.WithSecret("hunter2", "***"), "hunter2") == "***");
+	}
+
+	SECTION("Secret inside a longer secret")
+	{
+		const auto nested = SecretScrubber{}
+			.WithSecret("CDE", "<SHORT>")
+			.WithSecret("ABCDEFGH", "<LONG>");
+
+		REQUIRE(Scrub(nested, "ABCDEFGH") == "<LONG>");
+		REQUIRE(Scrub(nested, "xABCDEFGHx CDE") == "x<LONG>x <SHORT>");
+
+		const auto prefix = SecretScrubber{}
+			.WithSecret("ABC", "<SHORT>")
+			.WithSecret("ABCDEF", "<LONG>");
+
+		REQUIRE(Scrub(prefix, "ABCDEF") == "<LONG>");
+		REQUIRE(Scrub(prefix, "ABCDE") == "<SHORT>DE");
+
+		// The long secret only shows up after both short ones have already been found
+		const auto several = SecretScrubber{}
+			.WithSecret("CDE", "<S>")
+			.WithSecret("FG", "<F>")
+			.WithSecret("ABCDEFGH", "<L>");
+
+		REQUIRE(Scrub(several, "xxABCDEFGHyy") == "xx<L>yy");
+		REQUIRE(Scrub(several, "xxABCDEFGyy") == "xxAB<S><F>yy");
+	}
+
+	SECTION("Partially overlapping secrets")
+	{
+		const auto overlapping = SecretScrubber{}
+			.WithSecret("ABCD", "<1>")
+			.WithSecret("CDEF", "<2>");
+
+		// Neither secret can leak any of its characters
+		REQUIRE(Scrub(overlapping, "ABCDEF") == "<1><2>");
+		REQUIRE(Scrub(overlapping, "xxABCDEFxx") == "xx<1><2>xx");
+	}
+}
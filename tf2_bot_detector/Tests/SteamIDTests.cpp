@@ -0,0 +1,181 @@
+#include "SteamID.h"
+#include "Util/RegexUtils.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+
+using namespace std::string_view_literals;
+using namespace tf2_bot_detector;
+
+namespace
+{
+	// The original std::regex based parser, kept as the reference for the fuzz test below
+	std::optional<SteamID> ParseSteamIDRegex(const std::string_view& str)
+	{
+		static const std::regex s_SteamID3Regex(R"regex(\[([a-zA-Z]):(\d):(\d+)(?::(\d+))?\])regex", std::regex::optimize);
+		if (std::match_results<std::string_view::const_iterator> result;
+			std::regex_match(str.begin(), str.end(), result, s_SteamID3Regex))
+		{
+			SteamID id;
+
+			switch (*result[1].first)
+			{
+			case 'U': id.Type = SteamAccountType::Individual; break;
+			case 'M': id.Type = SteamAccountType::Multiseat; break;
+			case 'G': id.Type = SteamAccountType::GameServer; break;
+			case 'A': id.Type = SteamAccountType::AnonGameServer; break;
+			case 'P': id.Type = SteamAccountType::Pending; break;
+			case 'C': id.Type = SteamAccountType::ContentServer; break;
+			case 'g': id.Type = SteamAccountType::Clan; break;
+			case 'a': id.Type = SteamAccountType::AnonUser; break;
+
+			case 'T':
+			case 'L':
+			case 'c':
+				id.Type = SteamAccountType::Chat; break;
+
+			case 'I':
+				return SteamID();
+
+			default:
+				return std::nullopt;
+			}
+
+			uint32_t universe, accountID, instance;
+			if (!from_chars(result[2], universe) || !from_chars(result[3], accountID))
+				return std::nullopt;
+
+			id.Universe = static_cast<SteamAccountUniverse>(universe);
+			id.ID = accountID;
+
+			if (result[4].matched)
+			{
+				if (!from_chars(result[4], instance))
+					return std::nullopt;
+
+				id.Instance = static_cast<SteamAccountInstance>(instance);
+			}
+			else
+			{
+				id.Instance = SteamAccountInstance::Desktop;
+			}
+
+			return id;
+		}
+
+		if (std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit((unsigned char)c) || std::isspace((unsigned char)c); }))
+		{
+			uint64_t id64;
+			if (!mh::from_chars(str, id64))
+				return std::nullopt;
+
+			return SteamID(id64);
+		}
+
+		return std::nullopt;
+	}
+
+	std::optional<SteamID> TryParseSteamID(const std::string_view& str)
+	{
+		try
+		{
+			return SteamID(str);
+		}
+		catch (const std::invalid_argument&)
+		{
+			return std::nullopt;
+		}
+	}
+
+	std::string MutateSteamID(std::mt19937& random, std::string str)
+	{
+		static constexpr std::string_view ALPHABET = "[]:0123456789UIgaTXz _S\t"sv;
+
+		const auto mutations = std::uniform_int_distribution<int>(0, 3)(random);
+		for (int i = 0; i < mutations; i++)
+		{
+			const auto pos = std::uniform_int_distribution<size_t>(0, str.size())(random);
+			const char c = ALPHABET[std::uniform_int_distribution<size_t>(0, ALPHABET.size() - 1)(random)];
+
+			switch (std::uniform_int_distribution<int>(0, 2)(random))
+			{
+			case 0:
+				str.insert(str.begin() + pos, c);
+				break;
+			case 1:
+				if (pos < str.size())
+					str.erase(pos, 1);
+				break;
+			case 2:
+				if (pos < str.size())
+					str[pos] = c;
+				break;
+			}
+		}
+
+		return str;
+	}
+}
+
+TEST_CASE("tf2bd_steamid_parse", "[tf2bd]")
+{
+	REQUIRE(SteamID("[U:1:43645661]"sv) == SteamID(43645661, SteamAccountType::Individual));
+	REQUIRE(SteamID("[U:1:43645661:4]"sv) == SteamID(43645661, SteamAccountType::Individual, SteamAccountUniverse::Public, SteamAccountInstance::Web));
+	REQUIRE(SteamID("76561198003911389"sv).IsPazer());
+	REQUIRE(SteamID("76561198003911389 "sv).IsPazer());
+	REQUIRE(SteamID("[I:0:0]"sv) == SteamID());
+
+	REQUIRE(SteamID("STEAM_0:1:21822830"sv) == SteamID(43645661, SteamAccountType::Individual));
+	REQUIRE(SteamID("STEAM_1:1:21822830"sv) == SteamID(43645661, SteamAccountType::Individual));
+
+	REQUIRE_THROWS_AS(SteamID("[U:1:4294967296]"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("[Q:1:1]"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("[U:1:]"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID(" 76561198003911389"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("18446744073709551616"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("STEAM_0:2:1"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID("STEAM_0:1:2147483648"sv), std::invalid_argument);
+	REQUIRE_THROWS_AS(SteamID(""sv), std::invalid_argument);
+}
+
+TEST_CASE("tf2bd_steamid_parse_fuzz", "[tf2bd]")
+{
+	static constexpr std::string_view SEEDS[] =
+	{
+		"[U:1:43645661]",
+		"[U:1:43645661:1]",
+		"[A:1:3512381448:12345]",
+		"[g:1:4294967295]",
+		"[I:0:0]",
+		"[c:1:0]",
+		"76561198003911389",
+		"76561198003911389  ",
+		"",
+	};
+
+	std::mt19937 random(1234);
+
+	for (int i = 0; i < 20000; i++)
+	{
+		const std::string input = MutateSteamID(random, std::string(SEEDS[i % std::size(SEEDS)]));
+
+		// Legacy STEAM_X:Y:Z ids didn't parse at all before, so there's nothing to compare against
+		if (input.starts_with("STEAM_"))
+			continue;
+
+		INFO("Input: \"" << input << '"');
+		const auto expected = ParseSteamIDRegex(input);
+		const auto actual = TryParseSteamID(input);
+
+		REQUIRE(expected.has_value() == actual.has_value());
+		if (expected)
+			REQUIRE(expected->ID64 == actual->ID64);
+	}
+}
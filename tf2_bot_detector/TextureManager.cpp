@@ -22,10 +22,14 @@ using namespace gl21;
 #include <glad/gl.h>
 
 #include <mh/concurrency/thread_sentinel.hpp>
+#include <mh/coroutine/future.hpp>
 #include <mh/memory/unique_object.hpp>
 
+#include <algorithm>
 #include <array>
+#include <queue>
 #include <set>
+#include <vector>
 
 using namespace tf2_bot_detector;
 
@@ -51,21 +55,72 @@ namespace
 
 	using TextureHandle = mh::unique_object<GLuint, TextureHandleTraits>;
 
+	// One big RGBA texture, divided into a grid of equally sized slots
+	class AtlasPage final
+	{
+	public:
+		AtlasPage(uint16_t slotWidth, uint16_t slotHeight);
+
+		GLuint GetHandle() const { return m_Handle; }
+		uint16_t GetSlotWidth() const { return m_SlotWidth; }
+		uint16_t GetSlotHeight() const { return m_SlotHeight; }
+
+		bool IsFull() const { return m_FreeSlots.empty(); }
+		bool IsEmpty() const { return m_FreeSlots.size() == size_t(m_Columns) * m_Rows; }
+
+		uint32_t AllocateSlot();
+		void FreeSlot(uint32_t slot);
+
+		void Upload(uint32_t slot, const Bitmap& bitmap);
+		TextureUVs GetUVs(uint32_t slot) const;
+
+	private:
+		// Each slot is surrounded by a copy of its image's edge pixels, so that linear filtering
+		// at the edge of one image doesn't pull in the one next to it
+		static constexpr uint16_t PADDING = 1;
+
+		// Images per row/column, unless that would make the page bigger than MAX_PAGE_SIZE
+		static constexpr uint16_t MAX_SLOTS_PER_ROW = 16;
+		static constexpr uint16_t MAX_PAGE_SIZE = 2048;
+
+		TextureHandle m_Handle{};
+		uint16_t m_SlotWidth{};
+		uint16_t m_SlotHeight{};
+		uint16_t m_Columns{};
+		uint16_t m_Rows{};
+		uint16_t m_Width{};
+		uint16_t m_Height{};
+		std::vector<uint32_t> m_FreeSlots;
+	};
+
 	class TextureManager;
 
 	class Texture final : public ITexture
 	{
 	public:
 		Texture(const TextureManager& manager, const Bitmap& bitmap, const TextureSettings& settings);
+		Texture(const TextureManager& manager, const Bitmap& bitmap, const TextureSettings& settings,
+			std::shared_ptr<AtlasPage> atlasPage);
+		~Texture() override { Evict(); }
 
-		handle_type GetHandle() const override { return m_Handle; }
+		handle_type GetHandle() const override;
 		const TextureSettings& GetSettings() const override { return m_Settings; }
+		TextureUVs GetUVs() const override;
+		bool IsEvicted() const override { return !m_Handle && !m_AtlasPage; }
 
 		uint16_t GetWidth() const override { return m_Width; }
 		uint16_t GetHeight() const override { return m_Height; }
 
+		const AtlasPage* GetAtlasPage() const { return m_AtlasPage.get(); }
+		uint64_t GetLastUsedFrame() const { return m_LastUsedFrame; }
+		void Evict();
+
 	private:
-		TextureHandle m_Handle{};
+		const TextureManager& m_Manager;
+		mutable uint64_t m_LastUsedFrame{};
+		TextureHandle m_Handle{};                 // If we have a texture all to ourselves
+		std::shared_ptr<AtlasPage> m_AtlasPage;   // If we were packed into an atlas
+		uint32_t m_AtlasSlot{};
 		TextureSettings m_Settings{};
 		uint16_t m_Width{};
 		uint16_t m_Height{};
@@ -78,7 +133,12 @@ namespace
 
 		void EndFrame() override;
 		std::shared_ptr<ITexture> CreateTexture(const Bitmap& bitmap, const TextureSettings& settings) override;
+		mh::task<std::shared_ptr<ITexture>> CreateTextureAsync(std::shared_ptr<const Bitmap> bitmap, const TextureSettings& settings) override;
 		size_t GetActiveTextureCount() const override { return m_Textures.size(); }
+		size_t GetPendingUploadCount() const override { return m_PendingUploads.size(); }
+		size_t GetAtlasPageCount() const override { return m_AtlasPages.size(); }
+
+		uint64_t GetFrameCount() const { return m_FrameCount; }
 
 #ifdef IMGUI_USE_GLBINDING
 		bool HasExtension(GLextension ext) const { return GetExtensions().contains(ext); }
@@ -93,6 +153,31 @@ namespace
 		const std::set<GLextension> m_Extensions = glbinding::aux::ContextInfo::extensions();
 #endif
 
+		// glTexImage2D is synchronous, so don't upload a whole scoreboard of avatars in a single frame
+		static constexpr size_t MAX_UPLOADS_PER_FRAME = 4;
+
+		// Upper bound on evictable textures kept alive. Should comfortably fit a full server's worth of avatars.
+		static constexpr size_t MAX_EVICTABLE_TEXTURES = 128;
+
+		// Anything bigger gets a texture of its own. Big enough for steam's "full" 184x184 avatars.
+		static constexpr uint32_t MAX_ATLAS_IMAGE_SIZE = 256;
+
+		void ProcessPendingUploads();
+		void EvictTextures();
+
+		// Returns a page with a free slot for an image of this size. For evictable images, the least
+		// recently drawn evictable image of the same size gives up its slot before a new page is created.
+		std::shared_ptr<AtlasPage> FindAtlasPage(uint16_t width, uint16_t height, bool evictable);
+		std::vector<std::shared_ptr<AtlasPage>> m_AtlasPages;
+
+		struct PendingUpload
+		{
+			std::shared_ptr<const Bitmap> m_Bitmap;
+			TextureSettings m_Settings{};
+			mh::promise<std::shared_ptr<ITexture>> m_Promise;
+		};
+		std::queue<PendingUpload> m_PendingUploads;
+
 		uint64_t m_FrameCount{};
 		std::vector<std::shared_ptr<Texture>> m_Textures;
 		mh::thread_sentinel m_Sentinel;
@@ -118,15 +203,188 @@ void TextureManager::EndFrame()
 		{
 			return t.use_count() == 1;
 		});
+
+	ProcessPendingUploads();
+	EvictTextures();
+
+	std::erase_if(m_AtlasPages, [](const std::shared_ptr<AtlasPage>& page)
+		{
+			return page->IsEmpty();
+		});
+
+	m_FrameCount++;
+}
+
+void TextureManager::ProcessPendingUploads()
+{
+	for (size_t i = 0; i < MAX_UPLOADS_PER_FRAME && !m_PendingUploads.empty(); i++)
+	{
+		PendingUpload upload = std::move(m_PendingUploads.front());
+		m_PendingUploads.pop();
+
+		try
+		{
+			upload.m_Promise.set_value(CreateTexture(*upload.m_Bitmap, upload.m_Settings));
+		}
+		catch (...)
+		{
+			upload.m_Promise.set_exception(std::current_exception());
+		}
+	}
+}
+
+void TextureManager::EvictTextures()
+{
+	const size_t evictableCount = std::count_if(m_Textures.begin(), m_Textures.end(),
+		[](const std::shared_ptr<Texture>& t) { return t->GetSettings().m_Evictable; });
+
+	if (evictableCount <= MAX_EVICTABLE_TEXTURES)
+		return;
+
+	// Least recently drawn first. Never evict something that was drawn this frame.
+	std::vector<Texture*> candidates;
+	for (const auto& texture : m_Textures)
+	{
+		if (texture->GetSettings().m_Evictable && texture->GetLastUsedFrame() < m_FrameCount)
+			candidates.push_back(texture.get());
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Texture* a, const Texture* b)
+		{
+			return a->GetLastUsedFrame() < b->GetLastUsedFrame();
+		});
+
+	const size_t evictCount = std::min(evictableCount - MAX_EVICTABLE_TEXTURES, candidates.size());
+	for (size_t i = 0; i < evictCount; i++)
+		candidates[i]->Evict();
+
+	std::erase_if(m_Textures, [](const std::shared_ptr<Texture>& t)
+		{
+			return t->IsEvicted();
+		});
 }
 
 std::shared_ptr<ITexture> TextureManager::CreateTexture(const Bitmap& bitmap, const TextureSettings& settings)
 {
 	m_Sentinel.check();
+
+	if (settings.m_Atlas && bitmap.GetWidth() <= MAX_ATLAS_IMAGE_SIZE && bitmap.GetHeight() <= MAX_ATLAS_IMAGE_SIZE)
+	{
+		auto page = FindAtlasPage(uint16_t(bitmap.GetWidth()), uint16_t(bitmap.GetHeight()), settings.m_Evictable);
+		return m_Textures.emplace_back(std::make_shared<Texture>(*this, bitmap, settings, std::move(page)));
+	}
+
 	return m_Textures.emplace_back(std::make_shared<Texture>(*this, bitmap, settings));
 }
 
+std::shared_ptr<AtlasPage> TextureManager::FindAtlasPage(uint16_t width, uint16_t height, bool evictable)
+{
+	const auto FindFreePage = [&]() -> std::shared_ptr<AtlasPage>
+	{
+		for (const auto& page : m_AtlasPages)
+		{
+			if (page->GetSlotWidth() == width && page->GetSlotHeight() == height && !page->IsFull())
+				return page;
+		}
+
+		return nullptr;
+	};
+
+	if (auto page = FindFreePage())
+		return page;
+
+	if (evictable)
+	{
+		Texture* leastRecentlyUsed = nullptr;
+		for (const auto& texture : m_Textures)
+		{
+			const AtlasPage* page = texture->GetAtlasPage();
+			if (!page || page->GetSlotWidth() != width || page->GetSlotHeight() != height)
+				continue;
+
+			// Never evict something that was drawn this frame
+			if (!texture->GetSettings().m_Evictable || texture->GetLastUsedFrame() >= m_FrameCount)
+				continue;
+
+			if (!leastRecentlyUsed || texture->GetLastUsedFrame() < leastRecentlyUsed->GetLastUsedFrame())
+				leastRecentlyUsed = texture.get();
+		}
+
+		if (leastRecentlyUsed)
+		{
+			leastRecentlyUsed->Evict();
+			if (auto page = FindFreePage())
+				return page;
+		}
+	}
+
+	return m_AtlasPages.emplace_back(std::make_shared<AtlasPage>(width, height));
+}
+
+mh::task<std::shared_ptr<ITexture>> TextureManager::CreateTextureAsync(std::shared_ptr<const Bitmap> bitmap, const TextureSettings& settings)
+{
+	m_Sentinel.check();
+
+	auto& upload = m_PendingUploads.emplace();
+	upload.m_Bitmap = std::move(bitmap);
+	upload.m_Settings = settings;
+	return upload.m_Promise.get_task();
+}
+
+auto Texture::GetHandle() const -> handle_type
+{
+	m_LastUsedFrame = m_Manager.GetFrameCount();
+
+	if (m_AtlasPage)
+		return m_AtlasPage->GetHandle();
+
+	return m_Handle;
+}
+
+TextureUVs Texture::GetUVs() const
+{
+	if (m_AtlasPage)
+		return m_AtlasPage->GetUVs(m_AtlasSlot);
+
+	return {};
+}
+
+void Texture::Evict()
+{
+	m_Handle.reset();
+
+	if (m_AtlasPage)
+	{
+		m_AtlasPage->FreeSlot(m_AtlasSlot);
+		m_AtlasPage.reset();
+	}
+}
+
+Texture::Texture(const TextureManager& manager, const Bitmap& bitmap, const TextureSettings& settings,
+	std::shared_ptr<AtlasPage> atlasPage) :
+	m_Manager(manager),
+	m_LastUsedFrame(manager.GetFrameCount()),
+	m_AtlasPage(std::move(atlasPage)),
+	m_Settings(settings),
+	m_Width(bitmap.GetWidth()),
+	m_Height(bitmap.GetHeight())
+{
+	m_AtlasSlot = m_AtlasPage->AllocateSlot();
+
+	try
+	{
+		m_AtlasPage->Upload(m_AtlasSlot, bitmap);
+	}
+	catch (...)
+	{
+		Evict();
+		throw;
+	}
+}
+
 Texture::Texture(const TextureManager& manager, const Bitmap& bitmap, const TextureSettings& settings) :
+	m_Manager(manager),
+	m_LastUsedFrame(manager.GetFrameCount()),
 	m_Settings(settings),
 	m_Width(bitmap.GetWidth()),
 	m_Height(bitmap.GetHeight())
@@ -193,3 +451,110 @@ Texture::Texture(const TextureManager& manager, const Bitmap& bitmap, const Text
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	}
 }
+
+AtlasPage::AtlasPage(uint16_t slotWidth, uint16_t slotHeight) :
+	m_SlotWidth(slotWidth),
+	m_SlotHeight(slotHeight)
+{
+	const uint16_t paddedWidth = slotWidth + PADDING * 2;
+	const uint16_t paddedHeight = slotHeight + PADDING * 2;
+
+	m_Columns = std::min<uint16_t>(MAX_SLOTS_PER_ROW, MAX_PAGE_SIZE / paddedWidth);
+	m_Rows = std::min<uint16_t>(MAX_SLOTS_PER_ROW, MAX_PAGE_SIZE / paddedHeight);
+	m_Width = m_Columns * paddedWidth;
+	m_Height = m_Rows * paddedHeight;
+
+	// Highest slot last, so slots are handed out starting from the top left
+	m_FreeSlots.resize(size_t(m_Columns) * m_Rows);
+	for (size_t i = 0; i < m_FreeSlots.size(); i++)
+		m_FreeSlots[i] = uint32_t(m_FreeSlots.size() - i - 1);
+
+	glGenTextures(1, &m_Handle.reset_and_get_ref());
+	assert(m_Handle);
+
+	glBindTexture(GL_TEXTURE_2D, m_Handle);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+uint32_t AtlasPage::AllocateSlot()
+{
+	assert(!IsFull());
+	const auto slot = m_FreeSlots.back();
+	m_FreeSlots.pop_back();
+	return slot;
+}
+
+void AtlasPage::FreeSlot(uint32_t slot)
+{
+	assert(std::find(m_FreeSlots.begin(), m_FreeSlots.end(), slot) == m_FreeSlots.end());
+	m_FreeSlots.push_back(slot);
+}
+
+void AtlasPage::Upload(uint32_t slot, const Bitmap& bitmap)
+{
+	assert(bitmap.GetWidth() == m_SlotWidth && bitmap.GetHeight() == m_SlotHeight);
+
+	// Everything in a page shares the same format, so expand to RGBA here instead of swizzling
+	const uint32_t width = bitmap.GetWidth();
+	const uint32_t height = bitmap.GetHeight();
+	const uint8_t channels = bitmap.GetChannelCount();
+	const auto src = static_cast<const uint8_t*>(bitmap.GetData());
+
+	const uint32_t paddedWidth = width + PADDING * 2;
+	const uint32_t paddedHeight = height + PADDING * 2;
+	std::vector<uint8_t> rgba(size_t(paddedWidth) * paddedHeight * 4);
+
+	for (uint32_t y = 0; y < paddedHeight; y++)
+	{
+		const uint32_t srcY = std::clamp<int64_t>(int64_t(y) - PADDING, 0, height - 1);
+		for (uint32_t x = 0; x < paddedWidth; x++)
+		{
+			const uint32_t srcX = std::clamp<int64_t>(int64_t(x) - PADDING, 0, width - 1);
+			const uint8_t* in = src + (size_t(srcY) * width + srcX) * channels;
+			uint8_t* out = &rgba[(size_t(y) * paddedWidth + x) * 4];
+
+			switch (channels)
+			{
+			case 1:
+				out[0] = out[1] = out[2] = in[0];
+				out[3] = 255;
+				break;
+			case 2:
+				out[0] = out[1] = out[2] = in[0];
+				out[3] = in[1];
+				break;
+			case 3:
+				out[0] = in[0];
+				out[1] = in[1];
+				out[2] = in[2];
+				out[3] = 255;
+				break;
+			case 4:
+				std::copy_n(in, 4, out);
+				break;
+			}
+		}
+	}
+
+	const GLint x = GLint(slot % m_Columns) * paddedWidth;
+	const GLint y = GLint(slot / m_Columns) * paddedHeight;
+
+	glBindTexture(GL_TEXTURE_2D, m_Handle);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+}
+
+TextureUVs AtlasPage::GetUVs(uint32_t slot) const
+{
+	const float x = float((slot % m_Columns) * (m_SlotWidth + PADDING * 2) + PADDING);
+	const float y = float((slot / m_Columns) * (m_SlotHeight + PADDING * 2) + PADDING);
+
+	TextureUVs uvs;
+	uvs.m_U0 = x / m_Width;
+	uvs.m_V0 = y / m_Height;
+	uvs.m_U1 = (x + m_SlotWidth) / m_Width;
+	uvs.m_V1 = (y + m_SlotHeight) / m_Height;
+	return uvs;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mh/coroutine/task.hpp>
+
 #include <memory>
 
 namespace tf2_bot_detector
@@ -9,6 +11,23 @@ namespace tf2_bot_detector
 	struct TextureSettings
 	{
 		bool m_EnableMips = false;
+
+		// If true, the texture manager may release the underlying texture once it hasn't
+		// been drawn in a while and there are too many live textures (see ITexture::IsEvicted).
+		bool m_Evictable = false;
+
+		// If true, small images are packed into a shared atlas texture instead of getting a texture
+		// of their own, so drawing lots of them doesn't mean lots of texture binds. Must be drawn
+		// using ITexture::GetUVs().
+		bool m_Atlas = false;
+	};
+
+	struct TextureUVs
+	{
+		float m_U0 = 0;
+		float m_V0 = 0;
+		float m_U1 = 1;
+		float m_V1 = 1;
 	};
 
 	class ITexture
@@ -18,9 +37,16 @@ namespace tf2_bot_detector
 
 		virtual ~ITexture() = default;
 
+		// Also marks the texture as used this frame, for the purposes of eviction.
 		virtual handle_type GetHandle() const = 0;
 		virtual const TextureSettings& GetSettings() const = 0;
 
+		// The part of GetHandle() this texture's image occupies. All of it, unless it was packed into an atlas.
+		virtual TextureUVs GetUVs() const = 0;
+
+		// True once the texture manager has released this texture. It should be recreated if needed again.
+		virtual bool IsEvicted() const = 0;
+
 		virtual uint16_t GetWidth() const = 0;
 		virtual uint16_t GetHeight() const = 0;
 	};
@@ -37,6 +63,12 @@ namespace tf2_bot_detector
 		virtual std::shared_ptr<ITexture> CreateTexture(const Bitmap& bitmap,
 			const TextureSettings& settings = {}) = 0;
 
+		// Queues the bitmap for upload during EndFrame(), limited to a few uploads per frame
+		virtual mh::task<std::shared_ptr<ITexture>> CreateTextureAsync(std::shared_ptr<const Bitmap> bitmap,
+			const TextureSettings& settings = {}) = 0;
+
 		virtual size_t GetActiveTextureCount() const = 0;
+		virtual size_t GetPendingUploadCount() const = 0;
+		virtual size_t GetAtlasPageCount() const = 0;
 	};
 }
@@ -9,6 +9,7 @@
 #include "Networking/LogsTFAPI.h"
 #include "TextureManager.h"
 #include "GenericErrors.h"
+#include "FrameScheduler.h"
 
 #include "Networking/HTTPHelpers.h"
 
@@ -129,8 +130,9 @@ void MainWindow::OnDrawScoreboard()
 				ImGui::Separator();
 			}
 
-			for (IPlayer& player : m_Application->m_MainState->GeneratePlayerPrintData())
-				OnDrawScoreboardRow(player);
+			UpdateScoreboardModel();
+			for (ScoreboardRow& row : m_ScoreboardModel.m_Rows)
+				OnDrawScoreboardRow(row);
 
 			ImGui::EndGroup();
 
@@ -161,43 +163,149 @@ static ImVec4 BlendColors(const std::array<float, 4>& dstColor, const std::array
 	return ImVec4(result);
 }
 
-void MainWindow::OnDrawScoreboardRow(IPlayer& player)
+void MainWindow::UpdateScoreboardModel()
 {
-	if (!m_Settings.m_LazyLoadAPIData)
-		TryGetAvatarTexture(player);
+	// Official player lists can change in the background without bumping any version
+	static constexpr auto MAX_MODEL_AGE = 5s;
+
+	const auto& world = m_Application->GetWorld();
+	const auto& modLogic = m_Application->GetModLogic();
+	const auto now = tfbd_clock_t::now();
+
+	if (m_ScoreboardModel.m_PlayerDataVersion == world.GetPlayerDataVersion() &&
+		m_ScoreboardModel.m_PlayerAttributesVersion == modLogic.GetPlayerAttributesVersion() &&
+		m_ScoreboardModel.m_LazyLoadAPIData == m_Settings.m_LazyLoadAPIData &&
+		(now - m_ScoreboardModelBuildTime) < MAX_MODEL_AGE)
+	{
+		return;
+	}
+
+	m_ScoreboardModel.m_PlayerDataVersion = world.GetPlayerDataVersion();
+	m_ScoreboardModel.m_PlayerAttributesVersion = modLogic.GetPlayerAttributesVersion();
+	m_ScoreboardModel.m_LazyLoadAPIData = m_Settings.m_LazyLoadAPIData;
+	m_ScoreboardModelBuildTime = now;
+
+	auto& rows = m_ScoreboardModel.m_Rows;
+	rows.clear();
+
+	for (IPlayer& player : m_Application->m_MainState->GeneratePlayerPrintData())
+	{
+		if (!m_Settings.m_LazyLoadAPIData)
+			TryGetAvatarTexture(player);
+
+		ScoreboardRow& row = rows.emplace_back();
+		row.m_Player = player.shared_from_this();
+
+		const auto playerName = player.GetNameSafe();
+		row.m_HasName = !playerName.empty();
+
+		if (player.GetConnectionState() != PlayerStatusState::Active || !row.m_HasName)
+			row.m_TextColor = ScoreboardRow::TextColor::Connecting;
+		else if (player.GetSteamID() == m_Settings.GetLocalSteamID())
+			row.m_TextColor = ScoreboardRow::TextColor::You;
+
+		if (auto userID = player.GetUserID())
+			row.m_UserID.fmt("{}", *userID);
+		else
+			row.m_UserID = "?";
+
+		row.m_TeamShareResult = modLogic.GetTeamShareResult(player);
+		row.m_Team = player.GetTeam();
+		row.m_Marks = modLogic.GetPlayerAttributes(player);
+
+		if (row.m_Marks.Has(PlayerAttribute::Cheater))
+			row.m_MarkColor = ScoreboardRow::MarkColor::Cheater;
+		else if (row.m_Marks.Has(PlayerAttribute::Suspicious))
+			row.m_MarkColor = ScoreboardRow::MarkColor::Suspicious;
+		else if (row.m_Marks.Has(PlayerAttribute::Exploiter))
+			row.m_MarkColor = ScoreboardRow::MarkColor::Exploiter;
+		else if (row.m_Marks.Has(PlayerAttribute::Racist))
+			row.m_MarkColor = ScoreboardRow::MarkColor::Racist;
+
+		const auto& summary = player.GetPlayerSummary();
+		if (row.m_HasName)
+			row.m_Name = playerName;
+		else if (summary && !summary->m_Nickname.empty())
+			row.m_Name = summary->m_Nickname;
+		else
+			row.m_Name = "<Unknown>";
+
+		// If their steamcommunity name doesn't match their ingame name
+		if (summary && row.m_HasName && summary->m_Nickname != playerName)
+			row.m_SteamNameMismatch = mh::format("({})", summary->m_Nickname);
+
+		static constexpr bool DEBUG_ALWAYS_DRAW_ICONS = false;
+		const auto AddIcon = [&](bool condition, const ITexture* icon, std::array<float, 4> color, std::string_view tooltip)
+		{
+			if ((condition || DEBUG_ALWAYS_DRAW_ICONS) && icon)
+				row.m_Icons.push_back({ icon, color, tooltip });
+		};
+
+		// Check their steam bans
+		if (auto bans = player.GetPlayerBans())
+		{
+			AddIcon(bans->m_VACBanCount > 0, m_BaseTextures->GetVACShield_16(), { 1, 1, 1, 1 }, "VAC Banned");
+			AddIcon(bans->m_GameBanCount > 0, m_BaseTextures->GetGameBanIcon_16(), { 1, 1, 1, 1 }, "Game Banned");
+		}
+
+		// If they are friends with us on Steam
+		AddIcon(player.IsFriend(), m_BaseTextures->GetHeart_16(), { 1, 0, 0, 1 }, "Steam Friends");
+
+		// They are SourceBanned
+		if (auto sourceBans = player.GetPlayerSourceBanState())
+			AddIcon(sourceBans->size() > 0, m_BaseTextures->GetSourceBansIcon_16(), { 1, 1, 1, 1 }, "Has SourceBans Entries");
+
+		if (row.m_HasName)
+		{
+			row.m_Kills.fmt("{}", player.GetScores().m_Kills);
+			row.m_Deaths.fmt("{}", player.GetScores().m_Deaths);
+			row.m_Ping.fmt("{}", player.GetPing());
+		}
+		else
+		{
+			row.m_Kills = "?";
+			row.m_Deaths = "?";
+			row.m_Ping = "?";
+		}
+
+		row.m_ConnectionTime = player.GetConnectionTime();
+
+		row.m_SteamID = player.GetSteamID().str();
+		row.m_SteamIDValid = player.GetSteamID().Type != SteamAccountType::Invalid;
+	}
+}
+
+// ~30fps is plenty for TimeSine()'s 1 second pulse
+static constexpr FrameScheduler::duration_type MARKED_ROW_ANIMATION_INTERVAL = std::chrono::milliseconds(33);
+
+void MainWindow::OnDrawScoreboardRow(ScoreboardRow& row)
+{
+	IPlayer& player = *row.m_Player;
+	const auto& colors = m_Settings.m_Theme.m_Colors;
 
-	const auto& playerName = player.GetNameSafe();
 	ImGuiDesktop::ScopeGuards::ID idScope((int)player.GetSteamID().Lower32);
 	ImGuiDesktop::ScopeGuards::ID idScope2((int)player.GetSteamID().Upper32);
 
 	ImGuiDesktop::ScopeGuards::StyleColor textColor;
-	if (player.GetConnectionState() != PlayerStatusState::Active || player.GetNameSafe().empty())
-		textColor = { ImGuiCol_Text, m_Settings.m_Theme.m_Colors.m_ScoreboardConnectingFG };
-	else if (player.GetSteamID() == m_Settings.GetLocalSteamID())
-		textColor = { ImGuiCol_Text, m_Settings.m_Theme.m_Colors.m_ScoreboardYouFG };
-
-	mh::fmtstr<32> buf;
-	if (!player.GetUserID().has_value())
-		buf = "?";
-	else
-		buf.fmt("{}", player.GetUserID().value());
+	if (row.m_TextColor == ScoreboardRow::TextColor::Connecting)
+		textColor = { ImGuiCol_Text, colors.m_ScoreboardConnectingFG };
+	else if (row.m_TextColor == ScoreboardRow::TextColor::You)
+		textColor = { ImGuiCol_Text, colors.m_ScoreboardYouFG };
 
 	bool shouldDrawPlayerTooltip = false;
 
 	// Selectable
-	const auto teamShareResult = m_Application->GetModLogic().GetTeamShareResult(player);
-	const auto playerAttribs = m_Application->GetModLogic().GetPlayerAttributes(player);
 	{
 		ImVec4 bgColor = [&]() -> ImVec4
 		{
-			switch (teamShareResult)
+			switch (row.m_TeamShareResult)
 			{
-			case TeamShareResult::SameTeams:      return m_Settings.m_Theme.m_Colors.m_ScoreboardFriendlyTeamBG;
-			case TeamShareResult::OppositeTeams:  return m_Settings.m_Theme.m_Colors.m_ScoreboardEnemyTeamBG;
+			case TeamShareResult::SameTeams:      return colors.m_ScoreboardFriendlyTeamBG;
+			case TeamShareResult::OppositeTeams:  return colors.m_ScoreboardEnemyTeamBG;
 			case TeamShareResult::Neither:        break;
 			}
 
-			switch (player.GetTeam())
+			switch (row.m_Team)
 			{
 			case TFTeam::Red:   return ImVec4(1.0f, 0.5f, 0.5f, 0.5f);
 			case TFTeam::Blue:  return ImVec4(0.5f, 0.5f, 1.0f, 0.5f);
@@ -205,14 +313,27 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 			}
 		}();
 
-		if (playerAttribs.Has(PlayerAttribute::Cheater))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardCheaterBG, m_Application->TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Suspicious))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardSuspiciousBG, m_Application->TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Exploiter))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardExploiterBG, m_Application->TimeSine());
-		else if (playerAttribs.Has(PlayerAttribute::Racist))
-			bgColor = BlendColors(bgColor.to_array(), m_Settings.m_Theme.m_Colors.m_ScoreboardRacistBG, m_Application->TimeSine());
+		// The marked row pulse has to keep moving even when nothing else is happening
+		if (row.m_MarkColor != ScoreboardRow::MarkColor::None)
+			GetFrameScheduler().RequestAnimationFrames(MARKED_ROW_ANIMATION_INTERVAL);
+
+		switch (row.m_MarkColor)
+		{
+		case ScoreboardRow::MarkColor::Cheater:
+			bgColor = BlendColors(bgColor.to_array(), colors.m_ScoreboardCheaterBG, m_Application->TimeSine());
+			break;
+		case ScoreboardRow::MarkColor::Suspicious:
+			bgColor = BlendColors(bgColor.to_array(), colors.m_ScoreboardSuspiciousBG, m_Application->TimeSine());
+			break;
+		case ScoreboardRow::MarkColor::Exploiter:
+			bgColor = BlendColors(bgColor.to_array(), colors.m_ScoreboardExploiterBG, m_Application->TimeSine());
+			break;
+		case ScoreboardRow::MarkColor::Racist:
+			bgColor = BlendColors(bgColor.to_array(), colors.m_ScoreboardRacistBG, m_Application->TimeSine());
+			break;
+		case ScoreboardRow::MarkColor::None:
+			break;
+		}
 
 		ImGuiDesktop::ScopeGuards::StyleColor styleColorScope(ImGuiCol_Header, bgColor);
 
@@ -221,7 +342,7 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 
 		bgColor.w = std::min(bgColor.w + 0.5f, 1.0f);
 		ImGuiDesktop::ScopeGuards::StyleColor styleColorScopeActive(ImGuiCol_HeaderActive, bgColor);
-		ImGui::Selectable(buf.c_str(), true, ImGuiSelectableFlags_SpanAllColumns);
+		ImGui::Selectable(row.m_UserID.c_str(), true, ImGuiSelectableFlags_SpanAllColumns);
 
 		shouldDrawPlayerTooltip = ImGui::IsItemHovered();
 
@@ -232,105 +353,17 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 
 	// player names column
 	{
-		static constexpr bool DEBUG_ALWAYS_DRAW_ICONS = false;
-
 		const auto columnEndX = ImGui::GetCursorPosX() - ImGui::GetStyle().ItemSpacing.x + ImGui::GetColumnWidth();
 
-		if (!playerName.empty())
-			ImGui::TextFmt(playerName);
-		else if (const auto& summary = player.GetPlayerSummary(); summary && !summary->m_Nickname.empty())
-			ImGui::TextFmt(summary->m_Nickname);
-		else
-			ImGui::TextFmt("<Unknown>");
+		ImGui::TextFmt(row.m_Name);
 
-		// If their steamcommunity name doesn't match their ingame name
-		if (auto summary = player.GetPlayerSummary();
-			summary && !playerName.empty() && summary->m_Nickname != playerName)
+		if (!row.m_SteamNameMismatch.empty())
 		{
 			ImGui::SameLine();
-			ImGui::TextFmt({ 1, 0, 0, 1 }, "({})", summary->m_Nickname);
+			ImGui::TextFmt({ 1, 0, 0, 1 }, row.m_SteamNameMismatch);
 		}
 
-		// Move cursor pos up a few pixels if we have icons to draw
-		struct IconDrawData
-		{
-			ImTextureID m_Texture;
-			ImVec4 m_Color{ 1, 1, 1, 1 };
-			std::string_view m_Tooltip;
-		};
-		std::vector<IconDrawData> icons;
-
-		// Check their steam bans
-		if (auto bans = player.GetPlayerBans())
-		{
-			// If they are VAC banned
-			std::invoke([&]
-				{
-					if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-					{
-						if (bans->m_VACBanCount <= 0)
-							return;
-					}
-
-					auto icon = m_BaseTextures->GetVACShield_16();
-					if (!icon)
-						return;
-
-					icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 1, 1, 1 }, "VAC Banned" });
-				});
-
-			// If they are game banned
-			std::invoke([&]
-				{
-					if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-					{
-						if (bans->m_GameBanCount <= 0)
-							return;
-					}
-
-					auto icon = m_BaseTextures->GetGameBanIcon_16();
-					if (!icon)
-						return;
-
-					icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 1, 1, 1 }, "Game Banned" });
-				});
-		}
-
-		// If they are friends with us on Steam
-		std::invoke([&]
-			{
-				if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-				{
-					if (!player.IsFriend())
-						return;
-				}
-
-				auto icon = m_BaseTextures->GetHeart_16();
-				if (!icon)
-					return;
-
-				icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 0, 0, 1 }, "Steam Friends" });
-			});
-
-		// They are SourceBanned
-		if (auto sourceBans = player.GetPlayerSourceBanState()) {
-			std::invoke([&]
-				{
-					if constexpr (!DEBUG_ALWAYS_DRAW_ICONS)
-					{
-						if (sourceBans->size() <= 0)
-							return;
-					}
-
-					auto icon = m_BaseTextures->GetSourceBansIcon_16();
-					if (!icon)
-						return;
-
-					icons.push_back({ (ImTextureID)(intptr_t)icon->GetHandle(), { 1, 1, 1, 1 }, "Has SourceBans Entries" });
-				});
-		}
-
-		if (!icons.empty())
+		if (!row.m_Icons.empty())
 		{
 			// We have at least one icon to draw
 			ImGui::SameLine();
@@ -341,14 +374,16 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 			const float iconSize = 16 * ImGui::GetCurrentFontScale();
 
 			const auto spacing = ImGui::GetStyle().ItemSpacing.x;
-			ImGui::SetCursorPosX(columnEndX - (iconSize + spacing) * icons.size());
+			ImGui::SetCursorPosX(columnEndX - (iconSize + spacing) * row.m_Icons.size());
 
-			for (size_t i = 0; i < icons.size(); i++)
+			for (const auto& icon : row.m_Icons)
 			{
-				ImGui::Image(icons[i].m_Texture, { iconSize, iconSize }, { 0, 0 }, { 1, 1 }, icons[i].m_Color);
+				const auto uvs = icon.m_Texture->GetUVs();
+				ImGui::Image((ImTextureID)(intptr_t)icon.m_Texture->GetHandle(), { iconSize, iconSize },
+					{ uvs.m_U0, uvs.m_V0 }, { uvs.m_U1, uvs.m_V1 }, icon.m_Color);
 
 				ImGuiDesktop::ScopeGuards::TextColor color({ 1, 1, 1, 1 });
-				if (ImGui::SetHoverTooltip(icons[i].m_Tooltip))
+				if (ImGui::SetHoverTooltip(icon.m_Tooltip))
 					shouldDrawPlayerTooltip = false;
 
 				ImGui::SameLine(0, spacing);
@@ -359,64 +394,51 @@ void MainWindow::OnDrawScoreboardRow(IPlayer& player)
 	}
 
 	// Kills column
-	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetScores().m_Kills);
-
-		ImGui::NextColumn();
-	}
+	ImGui::TextRightAligned(row.m_Kills.view());
+	ImGui::NextColumn();
 
 	// Deaths column
-	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetScores().m_Deaths);
-
-		ImGui::NextColumn();
-	}
+	ImGui::TextRightAligned(row.m_Deaths.view());
+	ImGui::NextColumn();
 
 	// Connected time column
 	{
-		if (playerName.empty())
+		if (!row.m_HasName)
 		{
 			ImGui::TextRightAligned("?");
 		}
 		else
 		{
-			ImGui::TextRightAlignedF("%u:%02u",
-				std::chrono::duration_cast<std::chrono::minutes>(player.GetConnectedTime()).count(),
-				std::chrono::duration_cast<std::chrono::seconds>(player.GetConnectedTime()).count() % 60);
+			const auto connectedTime = std::max<duration_t>(m_Application->GetWorld().GetCurrentTime() - row.m_ConnectionTime, 0s);
+			if (const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(connectedTime).count();
+				seconds != row.m_ConnectedTimeSeconds)
+			{
+				row.m_ConnectedTimeSeconds = seconds;
+				row.m_ConnectedTime.fmt("{}:{:02}", seconds / 60, seconds % 60);
+			}
+
+			ImGui::TextRightAligned(row.m_ConnectedTime.view());
 		}
 
 		ImGui::NextColumn();
 	}
 
 	// Ping column
-	{
-		if (playerName.empty())
-			ImGui::TextRightAligned("?");
-		else
-			ImGui::TextRightAlignedF("%u", player.GetPing());
-
-		ImGui::NextColumn();
-	}
+	ImGui::TextRightAligned(row.m_Ping.view());
+	ImGui::NextColumn();
 
 	// Steam ID column
 	{
-		const auto str = player.GetSteamID().str();
-		if (player.GetSteamID().Type != SteamAccountType::Invalid)
-			ImGui::TextFmt(ImGui::GetStyle().Colors[ImGuiCol_Text], str);
+		if (row.m_SteamIDValid)
+			ImGui::TextFmt(ImGui::GetStyle().Colors[ImGuiCol_Text], row.m_SteamID);
 		else
-			ImGui::TextFmt(str);
+			ImGui::TextFmt(row.m_SteamID);
 
 		ImGui::NextColumn();
 	}
 
 	if (shouldDrawPlayerTooltip)
-		DrawPlayerTooltip(player, teamShareResult, playerAttribs);
+		DrawPlayerTooltip(player, row.m_TeamShareResult, row.m_Marks);
 }
 
 void MainWindow::OnDrawScoreboardContextMenu(IPlayer& player)
@@ -845,6 +867,20 @@ static void PrintPlayerMarkedFriendsCount(IPlayer& player, const IModeratorLogic
 						ImGui::TextFmt(COLOR_YELLOW, "{:v}", mh::enum_fmt(attrib));
 					}
 				}
+
+				if (markedFriends.m_CachedFriendsListsCount > 0)
+				{
+					ImGui::TextFmt("Friends of Friends Marked : ");
+					ImGui::SameLineNoPad();
+					if (markedFriends.m_MarkedFriendsOfFriendsCountTotal == 0)
+						ImGui::TextFmt("0 ");
+					else
+						ImGui::TextFmt(COLOR_YELLOW, "{} ", markedFriends.m_MarkedFriendsOfFriendsCountTotal);
+
+					ImGui::SameLineNoPad();
+					ImGui::TextFmt("(out of {}, from {} known friends lists)",
+						markedFriends.m_FriendsOfFriendsCountTotal, markedFriends.m_CachedFriendsListsCount);
+				}
 			});
 }
 
@@ -891,7 +927,8 @@ void MainWindow::DrawPlayerTooltipBody(IPlayer& player, TeamShareResult teamShar
 			})
 		.map([&](const std::shared_ptr<ITexture>& tex)
 			{
-				ImGui::Image((ImTextureID)(intptr_t)tex->GetHandle(), { 184, 184 });
+				const auto uvs = tex->GetUVs();
+				ImGui::Image((ImTextureID)(intptr_t)tex->GetHandle(), { 184, 184 }, { uvs.m_U0, uvs.m_V0 }, { uvs.m_U1, uvs.m_V1 });
 			});
 
 	////////////////////////////////
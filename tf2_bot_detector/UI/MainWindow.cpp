@@ -8,6 +8,7 @@
 #include "Actions/ActionGenerators.h"
 #include "BaseTextures.h"
 #include "Filesystem.h"
+#include "FrameScheduler.h"
 #include "GenericErrors.h"
 #include "Log.h"
 #include "GameData/IPlayer.h"
@@ -18,6 +19,7 @@
 #include "Version.h"
 #include "GlobalDispatcher.h"
 #include "Networking/HTTPClient.h"
+#include "PerformanceWindow.h"
 #include "SettingsWindow.h"
 #include "Application.h"
 
@@ -51,7 +53,8 @@ MainWindow::MainWindow(TF2BDApplication* application) :
 	m_TextureManager(ITextureManager::Create()),
 	m_Application(application),
 	m_Settings(application->m_Settings),
-	m_SettingsWindow(std::make_unique<SettingsWindow>(m_Settings, *this))
+	m_SettingsWindow(std::make_unique<SettingsWindow>(m_Settings, *this)),
+	m_PerformanceWindow(std::make_unique<PerformanceWindow>())
 {
 	PrintDebugInfo();
 }
@@ -224,11 +227,17 @@ void MainWindow::OnDrawChat()
 			ImGui::PushTextWrapPos();
 
 			const IConsoleLine::PrintArgs args{ m_Settings, *m_Application->m_WorldState, *this };
+			m_ChatClipper.Begin();
 			for (auto it = m_Application->GetMainState()->m_PrintingLines.rbegin(); it != m_Application->GetMainState()->m_PrintingLines.rend(); ++it)
 			{
 				assert(*it);
-				(*it)->Print(args);
+				if (m_ChatClipper.BeginRow((*it)->GetID()))
+				{
+					(*it)->Print(args);
+					m_ChatClipper.EndRow();
+				}
 			}
+			m_ChatClipper.End();
 
 			ImGui::PopTextWrapPos();
 		});
@@ -240,9 +249,14 @@ void MainWindow::OnDrawAppLog()
 		{
 			ImGui::PushTextWrapPos();
 
-			const void* lastLogMsg = nullptr;
+			std::optional<uint64_t> lastLogMsg;
+			m_AppLogClipper.Begin();
 			for (const LogMessage& msg : ILogManager::GetInstance().GetVisibleMsgs())
 			{
+				lastLogMsg = msg.m_ID;
+				if (!m_AppLogClipper.BeginRow(msg.m_ID))
+					continue;
+
 				const std::tm timestamp = ToTM(msg.m_Timestamp);
 
 				ImGuiDesktop::ScopeGuards::ID id(&msg);
@@ -261,8 +275,9 @@ void MainWindow::OnDrawAppLog()
 						ImGui::SetClipboardText(msg.m_Text.c_str());
 				}
 
-				lastLogMsg = &msg;
+				m_AppLogClipper.EndRow();
 			}
+			m_AppLogClipper.End();
 
 			if (m_Application->m_LastLogMessage != lastLogMsg)
 			{
@@ -291,6 +306,18 @@ void MainWindow::OnDrawSettings()
 	}
 }
 
+void MainWindow::OnDrawPerformance()
+{
+	if (!b_PerformanceOpen)
+		return;
+
+	ImGui::SetNextWindowSize({ 600, 400 }, ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("Performance", &b_PerformanceOpen))
+		m_PerformanceWindow->OnDraw(m_Application->GetActionManager());
+
+	ImGui::End();
+}
+
 void MainWindow::OnDrawUpdateCheckPopup()
 {
 	static constexpr char POPUP_NAME[] = "Check for Updates##Popup";
@@ -565,9 +592,28 @@ void MainWindow::OnDraw()
 		
 		ImGui::TextFmt("FPS: {:1.1f}", 1000.0f / ImGui::GetIO().Framerate);
 
+		{
+			const FrameScheduler::Stats frameStats = GetFrameScheduler().GetStats();
+			ImGui::TextFmt("Frame Time: {:1.2f} ms (avg {:1.2f} ms)",
+				to_seconds<float>(frameStats.m_LastFrameTime) * 1000, to_seconds<float>(frameStats.m_AverageFrameTime) * 1000);
+			ImGui::TextFmt("Frames Drawn: {} | Updates Run: {}", frameStats.m_FramesDrawn, frameStats.m_UpdatesRun);
+
+			ImGui::TextFmt("Wakeups:");
+			for (size_t i = 0; i < frameStats.m_Wakeups.size(); i++)
+			{
+				ImGui::SameLine();
+				ImGui::TextFmt("{} {}", to_string_view(WakeReason(i)), frameStats.m_Wakeups[i]);
+			}
+		}
+
 		ImGui::Value("Texture Count", m_TextureManager->GetActiveTextureCount());
+		ImGui::Value("Pending Texture Uploads", m_TextureManager->GetPendingUploadCount());
+		ImGui::Value("Texture Atlas Pages", m_TextureManager->GetAtlasPageCount());
 
 		ImGui::TextFmt("RAM Usage: {:1.1f} MB", Platform::Processes::GetCurrentRAMUsage() / 1024.0f / 1024);
+		ImGui::TextFmt("Player Data: {} players (~{:1.1f} MB)", m_Application->GetWorld().GetPlayerDataCount(),
+			m_Application->GetWorld().GetApproxPlayerDataMemoryUsage() / 1024.0f / 1024);
+		ImGui::Value("Dropped Log Writes", ILogManager::GetInstance().GetDroppedMessageCount());
 
 		if (auto client = m_Settings.GetHTTPClient())
 		{
@@ -772,6 +818,9 @@ void MainWindow::OnDrawMenuBar()
 		if (ImGui::MenuItem("Settings")) {
 			ToggleSettingsPopup();
 		}
+
+		if (ImGui::MenuItem("Performance", nullptr, b_PerformanceOpen))
+			b_PerformanceOpen = !b_PerformanceOpen;
 	}
 
 	if (ImGui::BeginMenu("Help"))
@@ -829,6 +878,7 @@ void MainWindow::Draw()
 	}
 
 	this->OnDrawSettings();
+	this->OnDrawPerformance();
 
 	this->OnEndFrame();
 }
@@ -846,14 +896,14 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 	{
 		StateTask_t m_State;
 
-		static StateTask_t LoadAvatarAsync(mh::task<Bitmap> avatarBitmapTask,
+		static StateTask_t LoadAvatarAsync(mh::task<std::shared_ptr<const Bitmap>> avatarBitmapTask,
 			mh::dispatcher updateDispatcher, std::shared_ptr<ITextureManager> textureManager)
 		{
-			const Bitmap* avatarBitmap = nullptr;
+			std::shared_ptr<const Bitmap> avatarBitmap;
 
 			try
 			{
-				avatarBitmap = &(co_await avatarBitmapTask);
+				avatarBitmap = co_await avatarBitmapTask;
 			}
 			catch (...)
 			{
@@ -866,7 +916,10 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 
 			try
 			{
-				co_return textureManager->CreateTexture(*avatarBitmap);
+				TextureSettings settings{};
+				settings.m_Evictable = true;
+				settings.m_Atlas = true;
+				co_return co_await textureManager->CreateTextureAsync(std::move(avatarBitmap), settings);
 			}
 			catch (...)
 			{
@@ -895,8 +948,19 @@ mh::expected<std::shared_ptr<ITexture>, std::error_condition> MainWindow::TryGet
 	}
 
 	if (auto data = avatarData.try_get())
+	{
+		// Texture manager threw this one away, reload it (from the disk cache) next time
+		if (data->has_value() && data->value()->IsEvicted())
+		{
+			avatarData = {};
+			return std::errc::operation_in_progress;
+		}
+
 		return *data;
+	}
 	else
+	{
 		return std::errc::operation_in_progress;
+	}
 }
 
@@ -17,6 +17,8 @@
 #include "PlayerStatus.h"
 #include "GameData/TFConstants.h"
 #include "Application.h"
+#include "UI/ScoreboardModel.h"
+#include "UI/VariableHeightClipper.h"
 #include <mh/error/expected.hpp>
 
 #include <optional>
@@ -33,6 +35,7 @@ namespace tf2_bot_detector
 	class ITexture;
 	class ITextureManager;
 	class IUpdateManager;
+	class PerformanceWindow;
 	class SettingsWindow;
 
 	class MainWindow final
@@ -56,7 +59,11 @@ namespace tf2_bot_detector
 		void OnDrawAllPanesDisabled();
 
 		void OnDrawScoreboardContextMenu(IPlayer& player);
-		void OnDrawScoreboardRow(IPlayer& player);
+		void OnDrawScoreboardRow(ScoreboardRow& row);
+
+		ScoreboardModel m_ScoreboardModel;
+		time_point_t m_ScoreboardModelBuildTime{};
+		void UpdateScoreboardModel();
 		void OnDrawColorPicker(const char* name_id, std::array<float, 4>& color);
 		void OnDrawChat();
 		void OnDrawServerStats();
@@ -71,10 +78,16 @@ namespace tf2_bot_detector
 
 		void OnDrawAppLog();
 
+		VariableHeightClipper m_ChatClipper;
+		VariableHeightClipper m_AppLogClipper;
+
 		bool b_SettingsOpen = false;
 		void OnDrawSettings();
 		void ToggleSettingsPopup();
 
+		bool b_PerformanceOpen = false;
+		void OnDrawPerformance();
+
 		void OnDrawUpdateCheckPopup();
 		bool m_UpdateCheckPopupOpen = false;
 		void OpenUpdateCheckPopup();
@@ -109,6 +122,7 @@ namespace tf2_bot_detector
 
 		Settings& m_Settings;
 		std::unique_ptr<SettingsWindow> m_SettingsWindow;
+		std::unique_ptr<PerformanceWindow> m_PerformanceWindow;
 
 		/// <summary>
 		/// for "sleep when unfocused" feature.
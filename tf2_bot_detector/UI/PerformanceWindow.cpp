@@ -0,0 +1,162 @@
+#include "PerformanceWindow.h"
+#include "Actions/RCONActionManager.h"
+#include "Filesystem.h"
+#include "Log.h"
+#include "Platform/Platform.h"
+#include "Util/PerfCounters.h"
+
+#include <imgui.h>
+#include <misc/cpp/imgui_stdlib.h>
+#include <mh/text/case_insensitive_string.hpp>
+
+#include <algorithm>
+
+using namespace tf2_bot_detector;
+
+namespace
+{
+	double ToMilliseconds(Perf::clock_type::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+	double ToMicroseconds(Perf::clock_type::duration duration)
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+}
+
+void PerformanceWindow::OnDraw(RCONActionManager& actionManager)
+{
+	if (ImGui::Button("Reset"))
+	{
+		Perf::ResetCounters();
+		actionManager.ResetCommandLatencyStats();
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Dump Chrome Trace"))
+		DumpChromeTrace();
+
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	ImGui::InputText("Filter", &m_Filter);
+
+	if (ImGui::CollapsingHeader("RCON command latency"))
+		OnDrawRCONLatency(actionManager);
+
+	OnDrawCounters();
+}
+
+void PerformanceWindow::OnDrawCounters()
+{
+	auto stats = Perf::GetSnapshot();
+	std::sort(stats.begin(), stats.end(), [](const Perf::CounterStats& lhs, const Perf::CounterStats& rhs)
+		{
+			return lhs.m_Total > rhs.m_Total;
+		});
+
+	constexpr ImGuiTableFlags flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter |
+		ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchProp;
+
+	if (ImGui::BeginTable("PerfCounters", 5, flags))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 3);
+		ImGui::TableSetupColumn("Count");
+		ImGui::TableSetupColumn("Total (ms)");
+		ImGui::TableSetupColumn("Avg (us)");
+		ImGui::TableSetupColumn("Max (us)");
+		ImGui::TableHeadersRow();
+
+		for (const auto& counter : stats)
+		{
+			if (counter.m_Count == 0)
+				continue;
+
+			if (!m_Filter.empty() && mh::case_insensitive_view(counter.m_Name).find(mh::case_insensitive_view(m_Filter)) == counter.m_Name.npos)
+				continue;
+
+			ImGui::TableNextRow();
+
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(counter.m_Name.c_str());
+
+			ImGui::TableNextColumn();
+			ImGui::Text("%llu", (unsigned long long)counter.m_Count);
+
+			ImGui::TableNextColumn();
+			ImGui::Text("%.2f", ToMilliseconds(counter.m_Total));
+
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", ToMicroseconds(counter.m_Total) / counter.m_Count);
+
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", ToMicroseconds(counter.m_Max));
+		}
+
+		ImGui::EndTable();
+	}
+}
+
+void PerformanceWindow::OnDrawRCONLatency(RCONActionManager& actionManager)
+{
+	using Stats = RCONActionManager::CommandLatencyStats;
+
+	constexpr ImGuiTableFlags flags = ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter |
+		ImGuiTableFlags_BordersV | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+
+	if (!ImGui::BeginTable("RCONLatency", 5, flags))
+		return;
+
+	ImGui::TableSetupColumn("Command", ImGuiTableColumnFlags_WidthStretch, 2);
+	ImGui::TableSetupColumn("Count");
+	ImGui::TableSetupColumn("Avg (ms)");
+	ImGui::TableSetupColumn("Max (ms)");
+	ImGui::TableSetupColumn("Histogram (1ms - 4s+)", ImGuiTableColumnFlags_WidthStretch, 3);
+	ImGui::TableHeadersRow();
+
+	for (const auto& [name, stats] : actionManager.GetCommandLatencyStats())
+	{
+		if (!m_Filter.empty() && mh::case_insensitive_view(name).find(mh::case_insensitive_view(m_Filter)) == name.npos)
+			continue;
+
+		ImGui::TableNextRow();
+
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(name.c_str());
+
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", (unsigned long long)stats.m_Count);
+
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", ToMilliseconds(stats.m_Total) / stats.m_Count);
+
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", ToMilliseconds(stats.m_Max));
+
+		ImGui::TableNextColumn();
+		float buckets[Stats::BUCKET_COUNT];
+		for (size_t i = 0; i < Stats::BUCKET_COUNT; i++)
+			buckets[i] = float(stats.m_Buckets[i]);
+
+		ImGui::PushID(name.c_str());
+		ImGui::PlotHistogram("##Histogram", buckets, int(Stats::BUCKET_COUNT), 0, nullptr, 0, FLT_MAX,
+			{ ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeight() * 2 });
+		ImGui::PopID();
+	}
+
+	ImGui::EndTable();
+}
+
+void PerformanceWindow::DumpChromeTrace() try
+{
+	const auto path = IFilesystem::Get().GetLogsDir() / "perf_trace.json";
+	Perf::WriteChromeTrace(path);
+
+	Log("Wrote performance trace to {}", path);
+	Shell::ExploreToAndSelect(path);
+}
+catch (...)
+{
+	LogException(MH_SOURCE_LOCATION_CURRENT(), "Failed to write performance trace");
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace tf2_bot_detector
+{
+	class RCONActionManager;
+
+	// Live view of the Perf:: counters (see Util/PerfCounters.h) and RCON command latencies
+	class PerformanceWindow
+	{
+	public:
+		void OnDraw(RCONActionManager& actionManager);
+
+	private:
+		void DumpChromeTrace();
+		void OnDrawCounters();
+		void OnDrawRCONLatency(RCONActionManager& actionManager);
+
+		std::string m_Filter;
+	};
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Clock.h"
+#include "SteamID.h"
+#include "WorldState.h"
+#include "Config/PlayerListJSON.h"
+#include "GameData/TFConstants.h"
+
+#include <mh/text/fmtstr.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	class IPlayer;
+	class ITexture;
+
+	// Everything the scoreboard needs to draw one player, worked out ahead of time.
+	// Colors are stored as "which theme color" rather than the color itself so that
+	// theme edits show up without needing a rebuild.
+	struct ScoreboardRow
+	{
+		std::shared_ptr<IPlayer> m_Player;
+
+		enum class TextColor
+		{
+			Default,
+			Connecting,
+			You,
+		} m_TextColor = TextColor::Default;
+
+		// Which of the mark colors (if any) the background pulses towards
+		enum class MarkColor
+		{
+			None,
+			Cheater,
+			Suspicious,
+			Exploiter,
+			Racist,
+		} m_MarkColor = MarkColor::None;
+
+		TeamShareResult m_TeamShareResult{};
+		TFTeam m_Team{};
+		PlayerMarks m_Marks;
+
+		mh::fmtstr<32> m_UserID;
+		std::string m_Name;             // What to show in the name column
+		std::string m_SteamNameMismatch; // Steam community name, if it differs from the ingame name
+		bool m_HasName = false;
+
+		struct Icon
+		{
+			const ITexture* m_Texture;
+			std::array<float, 4> m_Color{ 1, 1, 1, 1 };
+			std::string_view m_Tooltip;
+		};
+		std::vector<Icon> m_Icons;
+
+		mh::fmtstr<16> m_Kills;
+		mh::fmtstr<16> m_Deaths;
+		mh::fmtstr<16> m_Ping;
+
+		// Connected time ticks up on its own, so only reformat it when the displayed value changes
+		time_point_t m_ConnectionTime{};
+		int64_t m_ConnectedTimeSeconds = -1;
+		mh::fmtstr<16> m_ConnectedTime;
+
+		std::string m_SteamID;
+		bool m_SteamIDValid = false;
+	};
+
+	struct ScoreboardModel
+	{
+		// Versions of the data the rows were built from. Rebuilt when these don't match.
+		uint64_t m_PlayerDataVersion = uint64_t(-1);
+		uint64_t m_PlayerAttributesVersion = uint64_t(-1);
+		bool m_LazyLoadAPIData = false;
+
+		std::vector<ScoreboardRow> m_Rows;
+	};
+}
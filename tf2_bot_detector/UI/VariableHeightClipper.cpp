@@ -0,0 +1,76 @@
+#include "VariableHeightClipper.h"
+
+#include <imgui.h>
+
+#include <cassert>
+
+using namespace tf2_bot_detector;
+
+void VariableHeightClipper::Begin()
+{
+	const float width = ImGui::GetContentRegionAvail().x;
+	const float fontSize = ImGui::GetFontSize();
+	const float itemSpacingY = ImGui::GetStyle().ItemSpacing.y;
+	if (width != m_Width || fontSize != m_FontSize || itemSpacingY != m_ItemSpacingY)
+	{
+		Invalidate();
+		m_Width = width;
+		m_FontSize = fontSize;
+		m_ItemSpacingY = itemSpacingY;
+	}
+
+	m_Frame++;
+	m_RowCount = 0;
+	m_CursorY = ImGui::GetCursorPosY();
+	m_VisibleMinY = ImGui::GetScrollY();
+	m_VisibleMaxY = m_VisibleMinY + ImGui::GetWindowHeight();
+}
+
+bool VariableHeightClipper::BeginRow(uint64_t id)
+{
+	assert(!m_CurrentRow);
+	m_RowCount++;
+
+	if (auto found = m_Rows.find(id); found != m_Rows.end())
+	{
+		Row& row = found->second;
+		row.m_LastSeenFrame = m_Frame;
+
+		if ((m_CursorY + row.m_Height) < m_VisibleMinY || m_CursorY > m_VisibleMaxY)
+		{
+			m_CursorY += row.m_Height;
+			return false;
+		}
+	}
+
+	// Either visible, or we don't know how tall it is yet
+	ImGui::SetCursorPosY(m_CursorY);
+	m_RowStartY = m_CursorY;
+	m_CurrentRow = id;
+	return true;
+}
+
+void VariableHeightClipper::EndRow()
+{
+	assert(m_CurrentRow);
+
+	m_CursorY = ImGui::GetCursorPosY();
+	m_Rows[*m_CurrentRow] = Row{ m_CursorY - m_RowStartY, m_Frame };
+	m_CurrentRow.reset();
+}
+
+void VariableHeightClipper::End()
+{
+	assert(!m_CurrentRow);
+
+	// Make sure the scroll region still covers the rows we skipped at the end
+	if (ImGui::GetCursorPosY() != m_CursorY)
+	{
+		ImGui::SetCursorPosY(m_CursorY);
+		ImGui::Dummy({ 0, 0 });
+	}
+
+	// Forget about rows that have gone away
+	if (m_Rows.size() > (m_RowCount * 2 + 64))
+		std::erase_if(m_Rows, [&](const auto& pair) { return pair.second.m_LastSeenFrame != m_Frame; });
+}
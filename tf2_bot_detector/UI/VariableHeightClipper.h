@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace tf2_bot_detector
+{
+	// Like ImGuiListClipper, but for rows that aren't all the same height (wrapped text).
+	// Each row's height is measured the first time it is drawn, and after that rows
+	// that are scrolled out of view are skipped over without being drawn at all.
+	// Cached heights are thrown away if the available width or the font changes.
+	// Rows are identified by an ID that must never be reused for a different row.
+	//
+	// Usage:
+	//   clipper.Begin();
+	//   for (auto& row : rows)
+	//   {
+	//     if (clipper.BeginRow(row.GetID()))
+	//     {
+	//       DrawRow(row);
+	//       clipper.EndRow();
+	//     }
+	//   }
+	//   clipper.End();
+	class VariableHeightClipper final
+	{
+	public:
+		void Begin();
+		bool BeginRow(uint64_t id);
+		void EndRow();
+		void End();
+
+		void Invalidate() { m_Rows.clear(); }
+
+	private:
+		struct Row
+		{
+			float m_Height = 0;
+			uint32_t m_LastSeenFrame = 0;
+		};
+		std::unordered_map<uint64_t, Row> m_Rows;
+
+		float m_Width = -1;
+		float m_FontSize = -1;
+		float m_ItemSpacingY = -1;
+
+		uint32_t m_Frame = 0;
+		size_t m_RowCount = 0;
+		float m_CursorY = 0;
+		float m_RowStartY = 0;
+		float m_VisibleMinY = 0;
+		float m_VisibleMaxY = 0;
+		std::optional<uint64_t> m_CurrentRow;
+	};
+}
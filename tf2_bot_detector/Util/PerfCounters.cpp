@@ -0,0 +1,321 @@
+#include "PerfCounters.h"
+
+#include <mh/text/format.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+
+using namespace tf2_bot_detector;
+using namespace tf2_bot_detector::Perf;
+
+namespace
+{
+	static constexpr size_t MAX_COUNTERS = 512;
+	static constexpr size_t TRACE_BUFFER_SIZE = 1024; // Per thread, a few seconds of the main thread
+
+	// Everything in ThreadData is only ever written by its own thread. Other threads
+	// read it for snapshots, so it's all relaxed atomics: a snapshot taken mid-update
+	// may be off by a sample, which is fine for this.
+	struct CounterData
+	{
+		std::atomic<uint64_t> m_Count{};
+		std::atomic<int64_t> m_TotalNs{};
+		std::atomic<int64_t> m_MaxNs{};
+	};
+
+	struct TraceEvent
+	{
+		std::atomic<CounterID> m_ID{ INVALID_COUNTER };
+		std::atomic<int64_t> m_StartNs{};
+		std::atomic<int64_t> m_DurationNs{};
+	};
+
+	struct ThreadData
+	{
+		explicit ThreadData(uint32_t index) : m_Index(index) {}
+
+		const uint32_t m_Index;
+
+		// Counters are zeroed lazily by the owning thread when this falls behind the
+		// registry's generation, so ResetCounters() never has to write to them itself.
+		std::atomic<uint32_t> m_Generation{};
+		std::array<CounterData, MAX_COUNTERS> m_Counters;
+
+		std::array<TraceEvent, TRACE_BUFFER_SIZE> m_Trace;
+		std::atomic<uint64_t> m_TraceWriteIndex{};
+	};
+
+	struct RetiredCounterData
+	{
+		uint64_t m_Count = 0;
+		int64_t m_TotalNs = 0;
+		int64_t m_MaxNs = 0;
+	};
+
+	// Hands a thread's data back to the registry when the thread exits
+	struct ThreadDataOwner
+	{
+		ThreadData* m_Data = nullptr;
+		~ThreadDataOwner();
+	};
+
+	// Plain bools/pointers, so these are still safe to read after ThreadDataOwner is destroyed
+	thread_local ThreadData* t_ThreadData = nullptr;
+	thread_local bool t_ThreadExited = false;
+
+	class Registry final
+	{
+	public:
+		CounterID Register(const std::string_view& name)
+		{
+			std::lock_guard lock(m_Mutex);
+
+			if (auto found = m_IDs.find(std::string(name)); found != m_IDs.end())
+				return found->second;
+
+			if (m_Names.size() >= MAX_COUNTERS)
+				return INVALID_COUNTER;
+
+			const auto id = CounterID(m_Names.size());
+			m_Names.emplace_back(name);
+			m_IDs.emplace(name, id);
+			return id;
+		}
+
+		// nullptr once the calling thread has started exiting
+		ThreadData* GetThreadData()
+		{
+			if (!t_ThreadData && !t_ThreadExited)
+			{
+				thread_local ThreadDataOwner t_Owner;
+
+				std::lock_guard lock(m_Mutex);
+				t_ThreadData = m_Threads.emplace_back(std::make_unique<ThreadData>(m_NextThreadIndex++)).get();
+				t_ThreadData->m_Generation = m_Generation.load();
+				t_Owner.m_Data = t_ThreadData;
+			}
+
+			return t_ThreadData;
+		}
+
+		// Folds the thread's counters into m_RetiredCounters and frees its data. Its trace
+		// events are lost, but by then they're usually too old to matter.
+		void RetireThread(ThreadData* thread)
+		{
+			std::lock_guard lock(m_Mutex);
+
+			const auto generation = m_Generation.load();
+			if (m_RetiredGeneration != generation)
+			{
+				m_RetiredCounters.clear();
+				m_RetiredGeneration = generation;
+			}
+
+			if (thread->m_Generation.load(std::memory_order_relaxed) == generation)
+			{
+				m_RetiredCounters.resize(m_Names.size());
+				for (size_t i = 0; i < m_RetiredCounters.size(); i++)
+				{
+					const auto& counter = thread->m_Counters[i];
+					auto& retired = m_RetiredCounters[i];
+					retired.m_Count += counter.m_Count.load(std::memory_order_relaxed);
+					retired.m_TotalNs += counter.m_TotalNs.load(std::memory_order_relaxed);
+					retired.m_MaxNs = std::max(retired.m_MaxNs, counter.m_MaxNs.load(std::memory_order_relaxed));
+				}
+			}
+
+			std::erase_if(m_Threads, [&](const auto& data) { return data.get() == thread; });
+		}
+
+		const clock_type::time_point m_Epoch = clock_type::now();
+		std::atomic<uint32_t> m_Generation{};
+
+		std::mutex m_Mutex;
+		std::vector<std::string> m_Names;
+		std::unordered_map<std::string, CounterID> m_IDs;
+
+		// Threads that are still running. Everything else has been added to m_RetiredCounters.
+		std::vector<std::unique_ptr<ThreadData>> m_Threads;
+		uint32_t m_NextThreadIndex = 0;
+
+		std::vector<RetiredCounterData> m_RetiredCounters;
+		uint32_t m_RetiredGeneration = 0;
+	};
+
+	Registry& GetRegistry()
+	{
+		// Intentionally leaked: threads from the http/thread pools can still be
+		// recording samples while static destructors run at exit.
+		static Registry& s_Registry = *new Registry();
+		return s_Registry;
+	}
+
+	ThreadDataOwner::~ThreadDataOwner()
+	{
+		t_ThreadExited = true;
+		t_ThreadData = nullptr;
+
+		if (m_Data)
+			GetRegistry().RetireThread(m_Data);
+	}
+
+	int64_t ToNanoseconds(clock_type::duration duration)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+	}
+}
+
+CounterID Perf::RegisterCounter(const std::string_view& name)
+{
+	return GetRegistry().Register(name);
+}
+
+void Perf::Record(CounterID id, clock_type::time_point start, clock_type::duration duration)
+{
+	if (id >= MAX_COUNTERS)
+		return;
+
+	auto& registry = GetRegistry();
+	auto* threadData = registry.GetThreadData();
+	if (!threadData)
+		return; // Some other thread_local's destructor, after ours
+
+	auto& thread = *threadData;
+
+	if (const auto generation = registry.m_Generation.load(std::memory_order_relaxed);
+		thread.m_Generation.load(std::memory_order_relaxed) != generation)
+	{
+		for (auto& counter : thread.m_Counters)
+		{
+			counter.m_Count.store(0, std::memory_order_relaxed);
+			counter.m_TotalNs.store(0, std::memory_order_relaxed);
+			counter.m_MaxNs.store(0, std::memory_order_relaxed);
+		}
+
+		thread.m_Generation.store(generation, std::memory_order_relaxed);
+	}
+
+	const auto durationNs = ToNanoseconds(duration);
+
+	// Single writer, so no need for read-modify-write operations
+	auto& counter = thread.m_Counters[id];
+	counter.m_Count.store(counter.m_Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	counter.m_TotalNs.store(counter.m_TotalNs.load(std::memory_order_relaxed) + durationNs, std::memory_order_relaxed);
+	if (durationNs > counter.m_MaxNs.load(std::memory_order_relaxed))
+		counter.m_MaxNs.store(durationNs, std::memory_order_relaxed);
+
+	const auto writeIndex = thread.m_TraceWriteIndex.load(std::memory_order_relaxed);
+	auto& event = thread.m_Trace[writeIndex % TRACE_BUFFER_SIZE];
+	event.m_ID.store(id, std::memory_order_relaxed);
+	event.m_StartNs.store(ToNanoseconds(start - registry.m_Epoch), std::memory_order_relaxed);
+	event.m_DurationNs.store(durationNs, std::memory_order_relaxed);
+	thread.m_TraceWriteIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+std::vector<CounterStats> Perf::GetSnapshot()
+{
+	auto& registry = GetRegistry();
+	std::lock_guard lock(registry.m_Mutex);
+
+	std::vector<CounterStats> stats(registry.m_Names.size());
+	for (size_t i = 0; i < stats.size(); i++)
+		stats[i].m_Name = registry.m_Names[i];
+
+	const auto generation = registry.m_Generation.load();
+	if (registry.m_RetiredGeneration == generation)
+	{
+		for (size_t i = 0; i < registry.m_RetiredCounters.size(); i++)
+		{
+			const auto& retired = registry.m_RetiredCounters[i];
+			stats[i].m_Count += retired.m_Count;
+			stats[i].m_Total += std::chrono::nanoseconds(retired.m_TotalNs);
+			stats[i].m_Max = std::max<clock_type::duration>(stats[i].m_Max, std::chrono::nanoseconds(retired.m_MaxNs));
+		}
+	}
+
+	for (const auto& thread : registry.m_Threads)
+	{
+		// Hasn't recorded anything since the last reset
+		if (thread->m_Generation.load(std::memory_order_relaxed) != generation)
+			continue;
+
+		for (size_t i = 0; i < stats.size(); i++)
+		{
+			const auto& counter = thread->m_Counters[i];
+			stats[i].m_Count += counter.m_Count.load(std::memory_order_relaxed);
+			stats[i].m_Total += std::chrono::nanoseconds(counter.m_TotalNs.load(std::memory_order_relaxed));
+			stats[i].m_Max = std::max<clock_type::duration>(stats[i].m_Max,
+				std::chrono::nanoseconds(counter.m_MaxNs.load(std::memory_order_relaxed)));
+		}
+	}
+
+	return stats;
+}
+
+void Perf::ResetCounters()
+{
+	GetRegistry().m_Generation++;
+}
+
+void Perf::WriteChromeTrace(const std::filesystem::path& path)
+{
+	auto& registry = GetRegistry();
+
+	nlohmann::json events = nlohmann::json::array();
+	{
+		std::lock_guard lock(registry.m_Mutex);
+
+		for (const auto& thread : registry.m_Threads)
+		{
+			events.push_back(
+				{
+					{ "name", "thread_name" },
+					{ "ph", "M" },
+					{ "pid", 1 },
+					{ "tid", thread->m_Index },
+					{ "args", { { "name", mh::format("Thread {}", thread->m_Index) } } },
+				});
+
+			const auto end = thread->m_TraceWriteIndex.load(std::memory_order_acquire);
+			const auto begin = end > TRACE_BUFFER_SIZE ? (end - TRACE_BUFFER_SIZE) : 0;
+			for (auto i = begin; i < end; i++)
+			{
+				const auto& event = thread->m_Trace[i % TRACE_BUFFER_SIZE];
+				const auto id = event.m_ID.load(std::memory_order_relaxed);
+				if (id >= registry.m_Names.size())
+					continue;
+
+				events.push_back(
+					{
+						{ "name", registry.m_Names[id] },
+						{ "cat", "tf2bd" },
+						{ "ph", "X" },
+						{ "pid", 1 },
+						{ "tid", thread->m_Index },
+						{ "ts", event.m_StartNs.load(std::memory_order_relaxed) / 1000.0 },
+						{ "dur", event.m_DurationNs.load(std::memory_order_relaxed) / 1000.0 },
+					});
+			}
+		}
+	}
+
+	const nlohmann::json trace =
+	{
+		{ "traceEvents", std::move(events) },
+		{ "displayTimeUnit", "ms" },
+	};
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.good())
+		throw std::filesystem::filesystem_error("Failed to open trace file for writing", path,
+			std::make_error_code(std::errc::io_error));
+
+	file << trace.dump();
+}
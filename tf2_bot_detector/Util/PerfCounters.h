@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tf2_bot_detector::Perf
+{
+	using clock_type = std::chrono::steady_clock;
+	using CounterID = uint32_t;
+
+	// Returned once the counter table is full. Recording to it does nothing.
+	inline constexpr CounterID INVALID_COUNTER = CounterID(-1);
+
+	// Looks up (or creates) the counter with this name. Takes a lock, so hot paths
+	// should do this once and keep the id around (TFBD_PERF_SCOPE does this for you).
+	CounterID RegisterCounter(const std::string_view& name);
+
+	// Adds a sample to the calling thread's stats and trace buffer. Lock free.
+	void Record(CounterID id, clock_type::time_point start, clock_type::duration duration);
+
+	class ScopedTimer final
+	{
+	public:
+		explicit ScopedTimer(CounterID id) : m_ID(id), m_Start(clock_type::now()) {}
+		~ScopedTimer() { Record(m_ID, m_Start, clock_type::now() - m_Start); }
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		CounterID m_ID;
+		clock_type::time_point m_Start;
+	};
+
+	struct CounterStats
+	{
+		std::string m_Name;
+		uint64_t m_Count = 0;
+		clock_type::duration m_Total{};
+		clock_type::duration m_Max{};
+	};
+
+	// Totals for every counter across all threads, in registration order
+	std::vector<CounterStats> GetSnapshot();
+	void ResetCounters();
+
+	// Writes the most recent samples of every thread in Chrome's trace event format
+	// (load it in chrome://tracing or https://ui.perfetto.dev).
+	void WriteChromeTrace(const std::filesystem::path& path);
+}
+
+#define TFBD_PERF_CONCAT_INNER(a, b) a ## b
+#define TFBD_PERF_CONCAT(a, b) TFBD_PERF_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope under the given (string literal) counter name
+#define TFBD_PERF_SCOPE(name) \
+	static const ::tf2_bot_detector::Perf::CounterID TFBD_PERF_CONCAT(s_PerfCounter_, __LINE__) = \
+		::tf2_bot_detector::Perf::RegisterCounter(name); \
+	const ::tf2_bot_detector::Perf::ScopedTimer TFBD_PERF_CONCAT(perfTimer_, __LINE__)(TFBD_PERF_CONCAT(s_PerfCounter_, __LINE__))
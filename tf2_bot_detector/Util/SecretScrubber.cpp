@@ -0,0 +1,164 @@
+#include "SecretScrubber.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace tf2_bot_detector;
+
+SecretScrubber SecretScrubber::WithSecret(std::string value, std::string replacement) const
+{
+	SecretScrubber retVal(*this);
+	if (value.empty())
+		return retVal;
+
+	for (auto& secret : retVal.m_Secrets)
+	{
+		if (secret.m_Value == value)
+		{
+			secret.m_Replacement = std::move(replacement);
+			return retVal;
+		}
+	}
+
+	retVal.m_Secrets.push_back(Secret
+		{
+			.m_Value = std::move(value),
+			.m_Replacement = std::move(replacement)
+		});
+
+	retVal.Rebuild();
+	return retVal;
+}
+
+void SecretScrubber::Rebuild()
+{
+	std::vector<State> states(1);
+
+	// Trie of all the secrets. 0 doubles as "no transition" since nothing can go back to the root.
+	for (size_t i = 0; i < m_Secrets.size(); i++)
+	{
+		uint32_t state = 0;
+		for (char c : m_Secrets[i].m_Value)
+		{
+			uint32_t next = states[state].m_Next[uint8_t(c)];
+			if (next == 0)
+			{
+				next = uint32_t(states.size());
+				states[state].m_Next[uint8_t(c)] = next;
+				states.emplace_back(); // Invalidates references into states
+			}
+
+			state = next;
+		}
+
+		states[state].m_Secret = int32_t(i);
+	}
+
+	// Breadth first, fill in the missing transitions from each state's failure state
+	std::vector<uint32_t> failure(states.size(), 0);
+	std::deque<uint32_t> queue;
+	for (uint32_t next : states[0].m_Next)
+	{
+		if (next != 0)
+			queue.push_back(next);
+	}
+
+	while (!queue.empty())
+	{
+		const uint32_t state = queue.front();
+		queue.pop_front();
+
+		// The failure state is a proper suffix of this one, so anything it matches is shorter
+		if (auto& secret = states[state].m_Secret; secret < 0)
+			secret = states[failure[state]].m_Secret;
+
+		for (size_t c = 0; c < 256; c++)
+		{
+			uint32_t& next = states[state].m_Next[c];
+			if (next != 0)
+			{
+				failure[next] = states[failure[state]].m_Next[c];
+				queue.push_back(next);
+			}
+			else
+			{
+				next = states[failure[state]].m_Next[c];
+			}
+		}
+	}
+
+	m_States = std::move(states);
+}
+
+void SecretScrubber::Replace(std::string& str) const
+{
+	if (m_States.empty())
+		return;
+
+	struct Match
+	{
+		size_t m_Start;
+		size_t m_End;
+		int32_t m_Secret;
+	};
+
+	// Only allocates if we actually find something
+	std::vector<Match> matches;
+
+	uint32_t state = 0;
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		state = m_States[state].m_Next[uint8_t(str[i])];
+
+		const int32_t secretIndex = m_States[state].m_Secret;
+		if (secretIndex < 0)
+			continue;
+
+		const size_t end = i + 1;
+		matches.push_back({ end - m_Secrets[secretIndex].m_Value.size(), end, secretIndex });
+	}
+
+	if (matches.empty())
+		return;
+
+	// A later match can start before earlier ones (a long secret around several short
+	// ones), so nothing can be written out until we've seen all of them.
+	std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b)
+		{
+			return a.m_Start != b.m_Start ? a.m_Start < b.m_Start : a.m_End > b.m_End;
+		});
+
+	// Sorted like this, a match is inside another one if something before it ends at or after it
+	size_t maxEnd = 0;
+	std::erase_if(matches, [&](const Match& match)
+		{
+			if (match.m_End <= maxEnd)
+				return true;
+
+			maxEnd = match.m_End;
+			return false;
+		});
+
+	std::string result;
+	result.reserve(str.size());
+
+	size_t copiedUpTo = 0;
+	for (size_t i = 0; i < matches.size(); )
+	{
+		result.append(str, copiedUpTo, matches[i].m_Start - copiedUpTo);
+
+		// Partially overlapping matches are replaced together, so the tail of neither one leaks
+		size_t runEnd = matches[i].m_End;
+		result.append(m_Secrets[matches[i].m_Secret].m_Replacement);
+		for (i++; i < matches.size() && matches[i].m_Start < runEnd; i++)
+		{
+			runEnd = matches[i].m_End;
+			result.append(m_Secrets[matches[i].m_Secret].m_Replacement);
+		}
+
+		copiedUpTo = runEnd;
+	}
+
+	result.append(str, copiedUpTo);
+	str = std::move(result);
+}
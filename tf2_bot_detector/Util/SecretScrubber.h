@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tf2_bot_detector
+{
+	// Replaces every occurrence of a set of secrets in a string. All of the secrets are
+	// compiled into a single DFA (Aho-Corasick), so strings only have to be scanned once
+	// no matter how many secrets there are. Immutable once built, so it can be shared
+	// between threads.
+	class SecretScrubber final
+	{
+	public:
+		SecretScrubber() = default;
+
+		// Returns a copy with value added (or its replacement updated, if it's already in here)
+		SecretScrubber WithSecret(std::string value, std::string replacement) const;
+
+		bool empty() const { return m_Secrets.empty(); }
+
+		// Secrets that overlap each other are replaced together, so no part of either one
+		// survives. A secret inside a longer one only gets the longer one's replacement.
+		void Replace(std::string& str) const;
+
+	private:
+		struct Secret
+		{
+			std::string m_Value;
+			std::string m_Replacement;
+		};
+		std::vector<Secret> m_Secrets;
+
+		struct State
+		{
+			std::array<uint32_t, 256> m_Next{};
+			int32_t m_Secret = -1; // Longest secret that ends in this state, if any
+		};
+		std::vector<State> m_States;
+
+		void Rebuild();
+	};
+}
@@ -21,6 +21,7 @@
 #include "GlobalDispatcher.h"
 #include "Application.h"
 #include "DB/TempDB.h"
+#include "FrameScheduler.h"
 
 #include "ConsoleLog/ConsoleLines/ChatConsoleLine.h"
 #include "ConsoleLog/ConsoleLines/LobbyHeaderLine.h"
@@ -81,8 +82,69 @@ void WorldState::Update()
 	m_PlayerSummaryUpdates.Update();
 	m_PlayerBansUpdates.Update();
 	m_PlayerSourceBansUpdates.Update();
+	m_PlayerPrefetcher.Update();
 
 	UpdateFriends();
+	EvictStalePlayers();
+}
+
+bool WorldState::CanEvictPlayer(const Player& player) const
+{
+	if (player.GetSteamID() == m_Settings.GetLocalSteamID())
+		return false;
+
+	// GetLobbyMembers() expects every lobby member to have a player
+	if (FindLobbyMemberTeam(player.GetSteamID()))
+		return false;
+
+	return true;
+}
+
+void WorldState::EvictStalePlayers()
+{
+	if ((tfbd_clock_t::now() - m_LastPlayerEvictionTime) < PLAYER_EVICTION_INTERVAL)
+		return;
+
+	m_LastPlayerEvictionTime = tfbd_clock_t::now();
+
+	const auto now = GetCurrentTime();
+	const size_t prevCount = m_CurrentPlayerData.size();
+
+	std::erase_if(m_CurrentPlayerData, [&](const auto& pair)
+		{
+			const Player& player = *pair.second;
+			return (now - player.GetLastStatusUpdateTime()) > PLAYER_DATA_EXPIRY && CanEvictPlayer(player);
+		});
+
+	if (m_CurrentPlayerData.size() > MAX_PLAYER_DATA_COUNT)
+	{
+		// Still too many, drop the ones we saw the longest time ago
+		std::vector<const Player*> candidates;
+		for (const auto& [id, player] : m_CurrentPlayerData)
+		{
+			if (CanEvictPlayer(*player))
+				candidates.push_back(player.get());
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [](const Player* a, const Player* b)
+			{
+				return a->GetLastStatusUpdateTime() < b->GetLastStatusUpdateTime();
+			});
+
+		const size_t evictCount = std::min(m_CurrentPlayerData.size() - MAX_PLAYER_DATA_COUNT, candidates.size());
+		for (size_t i = 0; i < evictCount; i++)
+			m_CurrentPlayerData.erase(candidates[i]->GetSteamID());
+	}
+
+	if (const size_t evicted = prevCount - m_CurrentPlayerData.size(); evicted > 0)
+	{
+		DebugLog("Evicted {} stale players, {} remaining", evicted, m_CurrentPlayerData.size());
+		BumpPlayerDataVersion();
+	}
+
+	m_ApproxPlayerDataMemoryUsage = 0;
+	for (const auto& [id, player] : m_CurrentPlayerData)
+		m_ApproxPlayerDataMemoryUsage += player->GetApproxMemoryUsage();
 }
 
 void WorldState::UpdateFriends()
@@ -110,6 +172,7 @@ void WorldState::UpdateFriends()
 		try
 		{
 			m_Friends = m_FriendsFuture.get();
+			BumpPlayerDataVersion();
 		}
 		catch (const http_error& e)
 		{
@@ -149,36 +212,57 @@ void WorldState::RemoveConsoleLineListener(IConsoleLineListener* listener)
 
 void WorldState::AddConsoleOutputChunk(const std::string_view& chunk)
 {
-	size_t last = 0;
-	for (auto i = chunk.find('\n', 0); i != chunk.npos; i = chunk.find('\n', last))
-	{
-		auto line = chunk.substr(last, i - last);
-		AddConsoleOutputLine(std::string(line));
-		last = i + 1;
-	}
+	ParseConsoleOutputAsync(std::string(chunk));
 }
 
 mh::task<> WorldState::AddConsoleOutputLine(std::string line)
+{
+	line.push_back('\n');
+	return ParseConsoleOutputAsync(std::move(line));
+}
+
+mh::task<> WorldState::ParseConsoleOutputAsync(std::string output)
 {
 	auto worldState = shared_from_this();
 
 	// Switch to thread "pool" thread (there is only 1 thread in this particular pool)
 	co_await m_ConsoleLineParsingPool.co_add_task();
 
-	auto parsed = IConsoleLine::ParseConsoleLine(line, GetCurrentTime(), *this);
+	struct ParsedLine
+	{
+		std::string_view m_Text;  // Points into output
+		std::shared_ptr<IConsoleLine> m_Parsed;
+	};
+	std::vector<ParsedLine> lines;
+	{
+		TFBD_PERF_SCOPE("Parse console output chunk");
+
+		const auto timestamp = GetCurrentTime();
+		const std::string_view outputView = output;
+
+		// Anything after the last newline is an incomplete line, and is dropped
+		size_t last = 0;
+		for (auto i = outputView.find('\n'); i != outputView.npos; i = outputView.find('\n', last))
+		{
+			const auto line = outputView.substr(last, i - last);
+			lines.push_back({ line, IConsoleLine::ParseConsoleLine(line, timestamp, *this) });
+			last = i + 1;
+		}
+	}
+
+	if (lines.empty())
+		co_return;
 
 	// switch to main thread
+	GetFrameScheduler().RequestFrame(WakeReason::RCON);
 	co_await GetDispatcher().co_dispatch();
 
-	if (parsed)
-	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineParsed(*worldState, *parsed);
-	}
-	else
+	for (const auto& line : lines)
 	{
-		for (auto listener : m_ConsoleLineListeners)
-			listener->OnConsoleLineUnparsed(*worldState, std::move(line));
+		if (line.m_Parsed)
+			m_ConsoleLineListenerBroadcaster.OnConsoleLineParsed(*worldState, *line.m_Parsed);
+		else
+			m_ConsoleLineListenerBroadcaster.OnConsoleLineUnparsed(*worldState, line.m_Text);
 	}
 }
 
@@ -196,6 +280,8 @@ void WorldState::ResetScoreboard()
 	for (const auto& [id, player] : m_CurrentPlayerData) {
 		player.get()->m_Scores = PlayerScores();
 	}
+
+	BumpPlayerDataVersion();
 }
 
 void WorldState::AddWorldEventListener(IWorldEventListener* listener)
@@ -227,30 +313,114 @@ std::optional<SteamID> WorldState::FindSteamIDForName(const std::string_view& pl
 
 std::optional<LobbyMemberTeam> WorldState::FindLobbyMemberTeam(const SteamID& id) const
 {
-	for (const auto& member : m_CurrentLobbyMembers)
+	if (auto member = FindLobbyMember(id))
+		return member->m_Team;
+
+	return std::nullopt;
+}
+
+std::optional<UserID_t> WorldState::FindUserID(const SteamID& id) const
+{
+	if (auto player = FindPlayer(id))
+		return player->GetUserID();
+
+	return std::nullopt;
+}
+
+const LobbyMember* WorldState::FindLobbyMember(const SteamID& id) const
+{
+	auto found = m_LobbyMemberIndex.find(id);
+	if (found == m_LobbyMemberIndex.end())
+		return nullptr;
+
+	const LobbyMemberSlots& slots = found->second;
+	if (slots.m_CurrentCount > 0)
+		return &m_CurrentLobbyMembers[slots.m_CurrentSlot];
+	if (slots.m_PendingCount > 0)
+		return &m_PendingLobbyMembers[slots.m_PendingSlot];
+
+	return nullptr;
+}
+
+void WorldState::SetLobbyMember(const LobbyMember& member)
+{
+	auto& vec = member.m_Pending ? m_PendingLobbyMembers : m_CurrentLobbyMembers;
+	if (member.m_Index >= vec.size())
+		return;
+
+	RemoveLobbyMemberSlotFromIndex(member.m_Pending, member.m_Index);
+	vec[member.m_Index] = member;
+
+	if (!member.IsValid())
+		return;
+
+	LobbyMemberSlots& slots = m_LobbyMemberIndex[member.m_SteamID];
+	if (member.m_Pending)
 	{
-		if (member.m_SteamID == id)
-			return member.m_Team;
+		slots.m_PendingCount++;
+		slots.m_PendingSlot = member.m_Index;
 	}
-
-	for (const auto& member : m_PendingLobbyMembers)
+	else
 	{
-		if (member.m_SteamID == id)
-			return member.m_Team;
+		slots.m_CurrentCount++;
+		slots.m_CurrentSlot = member.m_Index;
 	}
+}
 
-	return std::nullopt;
+void WorldState::ResizeLobbyMembers(size_t currentCount, size_t pendingCount)
+{
+	for (size_t i = currentCount; i < m_CurrentLobbyMembers.size(); i++)
+		RemoveLobbyMemberSlotFromIndex(false, unsigned(i));
+	for (size_t i = pendingCount; i < m_PendingLobbyMembers.size(); i++)
+		RemoveLobbyMemberSlotFromIndex(true, unsigned(i));
+
+	m_CurrentLobbyMembers.resize(currentCount);
+	m_PendingLobbyMembers.resize(pendingCount);
 }
 
-std::optional<UserID_t> WorldState::FindUserID(const SteamID& id) const
+void WorldState::ClearLobbyMembers()
 {
-	for (const auto& player : m_CurrentPlayerData)
+	m_CurrentLobbyMembers.clear();
+	m_PendingLobbyMembers.clear();
+	m_LobbyMemberIndex.clear();
+}
+
+void WorldState::RemoveLobbyMemberSlotFromIndex(bool pending, unsigned slot)
+{
+	const auto& vec = pending ? m_PendingLobbyMembers : m_CurrentLobbyMembers;
+	const LobbyMember& member = vec.at(slot);
+	if (!member.IsValid())
+		return;
+
+	auto found = m_LobbyMemberIndex.find(member.m_SteamID);
+	if (found == m_LobbyMemberIndex.end())
 	{
-		if (player.second->GetSteamID() == id)
-			return player.second->GetUserID();
+		assert(!"Lobby member missing from index");
+		return;
 	}
 
-	return std::nullopt;
+	LobbyMemberSlots& slots = found->second;
+	uint8_t& count = pending ? slots.m_PendingCount : slots.m_CurrentCount;
+	unsigned& indexedSlot = pending ? slots.m_PendingSlot : slots.m_CurrentSlot;
+	assert(count > 0);
+	count--;
+
+	if (count > 0 && indexedSlot == slot)
+	{
+		// Rare: the same player is in two slots while the lobby is being re-listed.
+		// Point at the other one.
+		for (unsigned i = 0; i < vec.size(); i++)
+		{
+			if (i != slot && vec[i].m_SteamID == member.m_SteamID)
+			{
+				indexedSlot = i;
+				break;
+			}
+		}
+	}
+
+	if (slots.m_CurrentCount == 0 && slots.m_PendingCount == 0)
+		m_LobbyMemberIndex.erase(found);
 }
 
 TeamShareResult WorldState::GetTeamShareResult(const SteamID& id) const
@@ -330,8 +500,8 @@ mh::generator<const IPlayer&> WorldState::GetLobbyMembers() const
 		if (!member.IsValid())
 			continue;
 
-		if (std::any_of(m_CurrentLobbyMembers.begin(), m_CurrentLobbyMembers.end(),
-			[&](const LobbyMember& member2) { return member.m_SteamID == member2.m_SteamID; }))
+		if (auto found = m_LobbyMemberIndex.find(member.m_SteamID);
+			found != m_LobbyMemberIndex.end() && found->second.m_CurrentCount > 0)
 		{
 			// Don't return two different instances with the same steamid.
 			continue;
@@ -443,10 +613,30 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 {
 	assert(&world == this);
 
+	switch (parsed.GetType())
+	{
+	case ConsoleLineType::LobbyHeader:
+	case ConsoleLineType::LobbyStatusFailed:
+	case ConsoleLineType::LobbyChanged:
+	case ConsoleLineType::LobbyMember:
+	case ConsoleLineType::HostNewGame:
+	case ConsoleLineType::Connecting:
+	case ConsoleLineType::ClientReachedServerSpawn:
+	case ConsoleLineType::ServerDroppedPlayer:
+	case ConsoleLineType::Ping:
+	case ConsoleLineType::PlayerStatus:
+	case ConsoleLineType::PlayerStatusShort:
+	case ConsoleLineType::KillNotification:
+		BumpPlayerDataVersion();
+		break;
+
+	default:
+		break;
+	}
+
 	const auto ClearLobbyState = [&]
 	{
-		m_CurrentLobbyMembers.clear();
-		m_PendingLobbyMembers.clear();
+		ClearLobbyMembers();
 		m_CurrentPlayerData.clear();
 	};
 
@@ -455,8 +645,7 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	case ConsoleLineType::LobbyHeader:
 	{
 		auto& headerLine = static_cast<const LobbyHeaderLine&>(parsed);
-		m_CurrentLobbyMembers.resize(headerLine.GetMemberCount());
-		m_PendingLobbyMembers.resize(headerLine.GetPendingCount());
+		ResizeLobbyMembers(headerLine.GetMemberCount(), headerLine.GetPendingCount());
 		break;
 	}
 	case ConsoleLineType::LobbyStatusFailed:
@@ -597,12 +786,14 @@ void WorldState::OnConsoleLineParsed(IWorldState& world, IConsoleLine& parsed)
 	{
 		auto& memberLine = static_cast<const LobbyMemberLine&>(parsed);
 		const auto& member = memberLine.GetLobbyMember();
-		auto& vec = member.m_Pending ? m_PendingLobbyMembers : m_CurrentLobbyMembers;
-		if (member.m_Index < vec.size())
-			vec[member.m_Index] = member;
+		SetLobbyMember(member);
 
 		const TFTeam tfTeam = member.m_Team == LobbyMemberTeam::Defenders ? TFTeam::Red : TFTeam::Blue;
-		FindOrCreatePlayer(member.m_SteamID).m_Team = tfTeam;
+		auto& player = FindOrCreatePlayer(member.m_SteamID);
+		player.m_Team = tfTeam;
+
+		// They'll be on the scoreboard as soon as they finish connecting
+		m_PlayerPrefetcher.Queue(player);
 
 		break;
 	}
@@ -781,15 +972,7 @@ Player& WorldState::FindOrCreatePlayer(const SteamID& id)
 		data = m_CurrentPlayerData.emplace(id, std::make_shared<Player>(*this, id)).first->second.get();
 
 		if (!GetSettings().m_LazyLoadAPIData)
-		{
-			data->GetPlayerSummary();
-			data->GetPlayerBans();
-			data->GetTF2Playtime();
-			data->GetLogsInfo();
-			data->GetFriendsInfo();
-			data->GetInventoryInfo();
-			data->GetPlayerSourceBanState();
-		}
+			m_PlayerPrefetcher.Queue(*data);
 	}
 
 
@@ -843,10 +1026,12 @@ void WorldState::PlayerSummaryUpdateAction::OnDataReady(WorldState*& state,
 	const response_type& response, queue_collection_type& collection)
 {
 	DebugLog("[SteamAPI] Received {} player summaries", response.size());
+	state->BumpPlayerDataVersion();
 	for (const SteamAPI::PlayerSummary& entry : response)
 	{
-		auto& player = state->FindOrCreatePlayer(entry.m_SteamID);
-		player.m_PlayerSummary = entry;
+		// Don't bring back players that were evicted while the request was in flight
+		if (auto player = state->FindPlayer(entry.m_SteamID))
+			static_cast<Player*>(player)->m_PlayerSummary = entry;
 
 		collection.erase(entry.m_SteamID);
 
@@ -881,9 +1066,12 @@ void WorldState::PlayerBansUpdateAction::OnDataReady(state_type& state,
 	const response_type& response, queue_collection_type& collection)
 {
 	DebugLog("[SteamAPI] Received {} player bans", response.size());
+	state->BumpPlayerDataVersion();
 	for (const SteamAPI::PlayerBans& bans : response)
 	{
-		state->FindOrCreatePlayer(bans.m_SteamID).m_PlayerSteamBans = bans;
+		if (auto player = state->FindPlayer(bans.m_SteamID))
+			static_cast<Player*>(player)->m_PlayerSteamBans = bans;
+
 		collection.erase(bans.m_SteamID);
 	}
 }
@@ -918,9 +1106,14 @@ void WorldState::PlayerSourceBansUpdateAction::OnDataReady(state_type& state,
 	const response_type& response, queue_collection_type& collection)
 {
 	DebugLog("[SteamHistory] Received {} player's bans", response.size());
+	state->BumpPlayerDataVersion();
 
 	for (const auto& steamID : collection) {
-		auto& player = state->FindOrCreatePlayer(steamID);
+		auto foundPlayer = state->FindPlayer(steamID);
+		if (!foundPlayer)
+			continue; // Evicted while the request was in flight
+
+		auto& player = *static_cast<Player*>(foundPlayer);
 		// SteamHistoryAPI::PlayerSourceBans
 
 		SteamHistoryAPI::PlayerSourceBanState banState;
@@ -30,6 +30,8 @@
 #include "ConsoleLog/ConsoleLineListener.h"
 #include "ConsoleLog/ConsoleLogParser.h"
 #include "BatchedAction.h"
+#include "GameData/PlayerPrefetcher.h"
+#include "Util/PerfCounters.h"
 #include <mh/algorithm/algorithm.hpp>
 #include <mh/concurrency/dispatcher.hpp>
 #include <mh/concurrency/main_thread.hpp>
@@ -111,6 +113,11 @@ namespace tf2_bot_detector
 		virtual const IPlayer* LocalPlayer() const = 0;
 
 		virtual size_t GetApproxLobbyMemberCount() const = 0;
+
+		// Changes whenever anything about the current players does (status, lobby,
+		// scores, api data, etc). Used to know when cached views of them are stale.
+		virtual uint64_t GetPlayerDataVersion() const = 0;
+
 		virtual mh::generator<const IPlayer&> GetLobbyMembers() const = 0;
 		mh::generator<IPlayer&> GetLobbyMembers();
 		virtual mh::generator<const IPlayer&> GetPlayers() const = 0;
@@ -124,6 +131,10 @@ namespace tf2_bot_detector
 		virtual const std::string& GetMapName() const = 0;
 
 		virtual const IAccountAges& GetAccountAges() const = 0;
+
+		// Number of players we are currently keeping data around for, and roughly how much memory that takes
+		virtual size_t GetPlayerDataCount() const = 0;
+		virtual size_t GetApproxPlayerDataMemoryUsage() const = 0;
 	};
 
 	inline mh::generator<IPlayer&> IWorldState::GetLobbyMembers()
@@ -164,6 +175,7 @@ namespace tf2_bot_detector
 		std::optional<SteamID> FindSteamIDForName(const std::string_view& playerName) const override;
 		std::optional<LobbyMemberTeam> FindLobbyMemberTeam(const SteamID& id) const override;
 		std::optional<UserID_t> FindUserID(const SteamID& id) const override;
+		const LobbyMember* FindLobbyMember(const SteamID& id) const;
 
 		TeamShareResult GetTeamShareResult(const SteamID& id) const override;
 		TeamShareResult GetTeamShareResult(const SteamID& id0, const SteamID& id1) const override;
@@ -201,6 +213,12 @@ namespace tf2_bot_detector
 		const std::string& GetServerHostName() const override { return m_ServerHostName; }
 		const std::string& GetMapName() const override { return m_MapName; }
 
+		uint64_t GetPlayerDataVersion() const override { return m_PlayerDataVersion; }
+		void BumpPlayerDataVersion() { m_PlayerDataVersion++; }
+
+		size_t GetPlayerDataCount() const override { return m_CurrentPlayerData.size(); }
+		size_t GetApproxPlayerDataMemoryUsage() const override { return m_ApproxPlayerDataMemoryUsage; }
+
 	protected:
 		virtual IConsoleLineListener& GetConsoleLineListenerBroadcaster() { return m_ConsoleLineListenerBroadcaster; }
 
@@ -218,6 +236,21 @@ namespace tf2_bot_detector
 		time_point_t m_LastFriendsUpdate{};
 
 		Player& FindOrCreatePlayer(const SteamID& id);
+		PlayerPrefetcher m_PlayerPrefetcher{ *this };
+
+		// Forget about players that haven't been seen in a while, so long sessions on
+		// community servers (where we never get a lobby to clear things) don't grow forever.
+		void EvictStalePlayers();
+		bool CanEvictPlayer(const Player& player) const;
+		time_point_t m_LastPlayerEvictionTime{};
+		size_t m_ApproxPlayerDataMemoryUsage = 0;
+
+		uint64_t m_PlayerDataVersion = 0;
+
+		// Lobby members and the local player are never evicted.
+		static constexpr duration_t PLAYER_EVICTION_INTERVAL = std::chrono::seconds(10);
+		static constexpr duration_t PLAYER_DATA_EXPIRY = std::chrono::minutes(15);
+		static constexpr size_t MAX_PLAYER_DATA_COUNT = 256;
 
 		struct PlayerSummaryUpdateAction final :
 			BatchedAction<WorldState*, SteamID, std::vector<SteamAPI::PlayerSummary>>
@@ -254,6 +287,22 @@ namespace tf2_bot_detector
 
 		std::vector<LobbyMember> m_CurrentLobbyMembers;
 		std::vector<LobbyMember> m_PendingLobbyMembers;
+
+		// Where each steamid lives in m_CurrentLobbyMembers/m_PendingLobbyMembers, so lobby
+		// lookups don't have to scan both lists. Kept up to date by the functions below.
+		struct LobbyMemberSlots
+		{
+			uint8_t m_CurrentCount = 0;
+			uint8_t m_PendingCount = 0;
+			unsigned m_CurrentSlot = 0;
+			unsigned m_PendingSlot = 0;
+		};
+		std::unordered_map<SteamID, LobbyMemberSlots> m_LobbyMemberIndex;
+		void SetLobbyMember(const LobbyMember& member);
+		void ResizeLobbyMembers(size_t currentCount, size_t pendingCount);
+		void ClearLobbyMembers();
+		void RemoveLobbyMemberSlotFromIndex(bool pending, unsigned slot);
+
 		std::unordered_map<SteamID, std::shared_ptr<Player>> m_CurrentPlayerData;
 		bool m_IsLocalPlayerInitialized = false;
 		bool m_IsVoteInProgress = false;
@@ -265,6 +314,9 @@ namespace tf2_bot_detector
 		std::unordered_set<IConsoleLineListener*> m_ConsoleLineListeners;
 		std::unordered_set<IWorldEventListener*> m_EventListeners;
 
+		// Parses every complete line of output as one job on m_ConsoleLineParsingPool, then
+		// hands them all to the listeners (in order) with a single trip back to the main thread.
+		mh::task<> ParseConsoleOutputAsync(std::string output);
 		mh::thread_pool m_ConsoleLineParsingPool{ 1 };
 		std::vector<mh::shared_future<std::shared_ptr<IConsoleLine>>> m_ConsoleLineParsingTasks;
 
@@ -274,16 +326,19 @@ namespace tf2_bot_detector
 
 			void OnConsoleLineParsed(IWorldState& world, IConsoleLine& line) override
 			{
+				TFBD_PERF_SCOPE("Broadcast OnConsoleLineParsed");
 				for (IConsoleLineListener* l : m_World.m_ConsoleLineListeners)
 					l->OnConsoleLineParsed(world, line);
 			}
 			void OnConsoleLineUnparsed(IWorldState& world, const std::string_view& text) override
 			{
+				TFBD_PERF_SCOPE("Broadcast OnConsoleLineUnparsed");
 				for (IConsoleLineListener* l : m_World.m_ConsoleLineListeners)
 					l->OnConsoleLineUnparsed(world, text);
 			}
 			void OnConsoleLogChunkParsed(IWorldState& world, bool consoleLinesParsed) override
 			{
+				TFBD_PERF_SCOPE("Broadcast OnConsoleLogChunkParsed");
 				for (IConsoleLineListener* l : m_World.m_ConsoleLineListeners)
 					l->OnConsoleLogChunkParsed(world, consoleLinesParsed);
 			}
@@ -294,6 +349,7 @@ namespace tf2_bot_detector
 		template<typename TRet, typename... TArgs, typename... TArgs2>
 		inline void InvokeEventListener(TRet(IWorldEventListener::* func)(TArgs... args), TArgs2&&... args)
 		{
+			TFBD_PERF_SCOPE("Broadcast world event");
 			for (IWorldEventListener* listener : m_EventListeners)
 				(listener->*func)(std::forward<TArgs2>(args)...);
 		}
@@ -111,13 +111,7 @@ void TF2BotDetectorSDLRenderer::DrawFrame()
 	SDL_Event event;
 
 	while (SDL_PollEvent(&event))
-	{
-		ImGui_ImplSDL2_ProcessEvent(&event);
-		if (event.type == SDL_QUIT)
-			running = false;
-		if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
-			running = false;
-	}
+		ProcessEvent(event);
 
 	// Start the Dear ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
@@ -145,7 +139,7 @@ void TF2BotDetectorSDLRenderer::DrawFrame()
 
 	if (showRendererSettings && ImGui::Begin("Renderer Settings", &showRendererSettings)) {
 
-		ImGui::Text("Note: This setting will still prefer vSync.");
+		ImGui::Text("Note: This setting will still prefer vSync. Frames are only drawn when something changed.");
 
 		ImGui::SliderFloat("Set Frame Time", &frameTime, 0.0f, 66.6f);
 
@@ -183,8 +177,7 @@ void TF2BotDetectorSDLRenderer::DrawFrame()
 
 	SDL_GL_SwapWindow(window);
 
-	// lmfao
-	SDL_Delay(static_cast<Uint32>(this->frameTime));
+	// frame pacing is left to whoever is calling DrawFrame (see WaitForEvents)
 }
 
 std::size_t TF2BotDetectorSDLRenderer::RegisterDrawCallback(DrawableCallbackFn function)
@@ -225,6 +218,42 @@ bool TF2BotDetectorSDLRenderer::InFocus() const
 	return SDL_GetWindowFlags(window) & (SDL_WINDOW_INPUT_FOCUS | SDL_WINDOW_MOUSE_FOCUS);
 }
 
+bool TF2BotDetectorSDLRenderer::WaitForEvents(int timeoutMs)
+{
+	bool receivedEvents = false;
+	SDL_Event event;
+
+	if (timeoutMs > 0 && SDL_WaitEventTimeout(&event, timeoutMs))
+		receivedEvents |= ProcessEvent(event);
+
+	while (SDL_PollEvent(&event))
+		receivedEvents |= ProcessEvent(event);
+
+	return receivedEvents;
+}
+
+bool TF2BotDetectorSDLRenderer::ProcessEvent(const SDL_Event& event)
+{
+	// our own wakeups carry no information, they just break us out of SDL_WaitEventTimeout
+	if (event.type == SDL_USEREVENT)
+		return false;
+
+	ImGui_ImplSDL2_ProcessEvent(&event);
+	if (event.type == SDL_QUIT)
+		running = false;
+	if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
+		running = false;
+
+	return true;
+}
+
+void TF2BotDetectorSDLRenderer::Wake()
+{
+	SDL_Event event{};
+	event.type = SDL_USEREVENT;
+	SDL_PushEvent(&event);
+}
+
 std::string TF2BotDetectorSDLRenderer::RendererInfo() const
 {
 	return "TF2BotDetectorSDLRenderer: OpenGl 4.3 + GLSL 430"; // fmt::format(FMT_COMPILE("TF2BotDetectorSDLRenderer: OpenGl GL 4.3 + GLSL 430"));
@@ -56,7 +56,19 @@ public:
 	bool InFocus() const;
 
 	std::string RendererInfo() const;
+
+	/// <summary>
+	/// sleeps until an SDL event arrives or the timeout expires, then processes everything queued.
+	/// </summary>
+	/// <returns>true if we got a real event (input, window events), not just a Wake()</returns>
+	bool WaitForEvents(int timeoutMs);
+
+	/// <summary>
+	/// breaks WaitForEvents out of its sleep. safe to call from any thread.
+	/// </summary>
+	void Wake();
 private:
+	bool ProcessEvent(const SDL_Event& event);
 
 	//std::vector<ITF2BotDetectorDrawable> drawable;
 	std::vector<DrawableCallbackFn> drawFunctions;